@@ -0,0 +1,115 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <threads.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/sharded.h"
+
+/*
+ * Pushes ITEMS items from each of 1, 2, 4 and 8 producer threads, first into
+ * one list guarded by a single mutex around ll_push_node(), then into a 
+ * sharded list with a shard per producer, and reports the throughput of each.
+ * Scaling only shows with at least as many online CPUs as producers, so the
+ * CPU count is printed along with the results.
+ */
+#define ITEMS 1000000
+
+static struct ll_node *head = 0;
+static mtx_t lock;
+static struct ll_sharded *sharded = 0;
+
+static int push_locked (void *arg)
+{
+    (void) arg;
+
+    for (intmax_t i = 0; i < ITEMS; i++) {
+        mtx_lock (&lock);
+        bool const ok = ll_push_node (&head, i);
+        mtx_unlock (&lock);
+
+        if (!ok) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int push_sharded (void *arg)
+{
+    (void) arg;
+
+    for (intmax_t i = 0; i < ITEMS; i++) {
+        if (!ll_sharded_push (sharded, i)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static double now (void)
+{
+    struct timespec ts;
+
+    timespec_get (&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/* Returns the throughput in millions of pushes per second, or -1 on failure. */
+static double run (int (*producer) (void *), size_t threads)
+{
+    thrd_t ids[8];
+    bool ok = true;
+    double const start = now ();
+
+    for (size_t i = 0; i < threads; i++) {
+        if (thrd_create (&ids[i], producer, 0) != thrd_success) {
+            return -1;
+        }
+    }
+    for (size_t i = 0; i < threads; i++) {
+        int res;
+
+        ok &= thrd_join (ids[i], &res) == thrd_success && !res;
+    }
+
+    double const elapsed = now () - start;
+
+    return ok ? (double) threads * ITEMS / elapsed / 1e6 : -1;
+}
+
+int main (void)
+{
+    if (mtx_init (&lock, mtx_plain) != thrd_success) {
+        return EXIT_FAILURE;
+    }
+    printf ("online CPUs: %ld\n", sysconf (_SC_NPROCESSORS_ONLN));
+    printf ("%-10s %16s %16s\n", "producers", "mutex Mpush/s", "sharded Mpush/s");
+
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+        double const locked = run (push_locked, threads);
+
+        ll_delete (&head);
+
+        sharded = ll_sharded_create (threads, LL_SHARD_BY_THREAD);
+        if (!sharded) {
+            return EXIT_FAILURE;
+        }
+
+        double const shards = run (push_sharded, threads);
+        /* The striped counters shall add up across the producers. */
+        bool const counted = ll_memory_usage (0).nodes == threads * ITEMS;
+
+        ll_sharded_delete (&sharded);
+
+        if (locked < 0 || shards < 0 || !counted) {
+            return EXIT_FAILURE;
+        }
+        printf ("%-10zu %16.2f %16.2f\n", threads, locked, shards);
+    }
+    mtx_destroy (&lock);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+#include "list.h"
+#include "internal.h"
+
+/*
+ * The counters of an allocator are striped: each thread adds to the stripe
+ * selected by its thread slot, and ll_memory_usage() sums them all. With no
+ * more threads than stripes, no two threads ever write the same cache line. 
+ * A block may be freed by another thread than the one that allocated it, so a
+ * single stripe can go below zero; the counters are unsigned and wrap, and the
+ * sum is still right.
+ *
+ * The stripes are allocated by ll_allocator_init(), and not through the 
+ * allocator itself, whose alloc may not honour their alignment.
+ */
+#define STRIPES 16
+
+struct stripe {
+    alignas (CACHE_LINE) atomic_size_t nodes;
+    atomic_size_t bytes;
+};
+
+struct ll_allocator_stats {
+    struct stripe stripes[STRIPES];
+};
+
+/*
+ * The default allocator is a thin wrapper around realloc() and free(), which
+ * is what the library always used.
+ */
+static void *default_alloc (void *context, size_t size)
+{
+    (void) context;
+    return realloc (0, size);
+}
+
+static void default_free (void *context, void *ptr, size_t size)
+{
+    (void) context;
+    (void) size;
+    free (ptr);
+}
+
+static struct ll_allocator_stats default_stats;
+
+static const struct ll_allocator default_allocator = {
+    .alloc = default_alloc,
+    .free = default_free,
+    .stats = &default_stats,
+};
+
+/* 
+ * The process-wide allocator, and the override of the calling thread, which is
+ * a NULL pointer when the thread has none.
+ */
+static const struct ll_allocator *_Atomic global = &default_allocator;
+static _Thread_local const struct ll_allocator *current;
+
+static atomic_size_t next_slot;
+static _Thread_local size_t thread_slot = SIZE_MAX;
+
+size_t ll_thread_slot (void)
+{
+    if (thread_slot == SIZE_MAX) {
+        thread_slot = atomic_fetch_add_explicit (&next_slot, 1, memory_order_relaxed);
+    }
+    return thread_slot;
+}
+
+bool ll_allocator_init (struct ll_allocator *allocator)
+{
+    assert (allocator && allocator->alloc && allocator->free);
+
+    allocator->stats = aligned_alloc (alignof (struct ll_allocator_stats),
+                                      sizeof *allocator->stats);
+    if (ISZERO (allocator->stats)) {
+        return false;
+    }
+    for (size_t i = 0; i < STRIPES; i++) {
+        atomic_init (&allocator->stats->stripes[i].nodes, 0);
+        atomic_init (&allocator->stats->stripes[i].bytes, 0);
+    }
+    return true;
+}
+
+void ll_allocator_destroy (struct ll_allocator *allocator)
+{
+    assert (allocator);
+
+    free (allocator->stats);
+    allocator->stats = 0;
+}
+
+void ll_set_default_allocator (const struct ll_allocator *allocator)
+{
+    assert (ISZERO (allocator) || allocator->stats);
+    atomic_store_explicit (&global, ISZERO (allocator) ? &default_allocator : allocator,
+                           memory_order_release);
+}
+
+void ll_set_allocator (const struct ll_allocator *allocator)
+{
+    assert (ISZERO (allocator) || allocator->stats);
+    current = allocator;
+}
+
+const struct ll_allocator *ll_get_allocator (void)
+{
+    return ISNONZERO (current) ? current 
+                               : atomic_load_explicit (&global, memory_order_acquire);
+}
+
+struct ll_memory_usage ll_memory_usage (const struct ll_allocator *allocator)
+{
+    const struct ll_allocator_stats *const stats = ISZERO (allocator) ? &default_stats 
+                                                                      : allocator->stats;
+    struct ll_memory_usage usage = { 0 };
+
+    assert (stats);
+
+    for (size_t i = 0; i < STRIPES; i++) {
+        usage.nodes += atomic_load_explicit (&stats->stripes[i].nodes, memory_order_relaxed);
+        usage.bytes += atomic_load_explicit (&stats->stripes[i].bytes, memory_order_relaxed);
+    }
+    return usage;
+}
+
+/*
+ * The counters are only statistics - nothing is ordered against them - so 
+ * relaxed operations suffice.
+ */
+static struct stripe *stripe_of (const struct ll_allocator *allocator)
+{
+    return &allocator->stats->stripes[ll_thread_slot () % STRIPES];
+}
+
+void *ll_alloc_bytes (const struct ll_allocator *allocator, size_t size)
+{
+    void *const ptr = allocator->alloc (allocator->context, size);
+
+    if (ISNONZERO (ptr)) {
+        atomic_fetch_add_explicit (&stripe_of (allocator)->bytes, size, memory_order_relaxed);
+    }
+    return ptr;
+}
+
+void ll_free_bytes (const struct ll_allocator *allocator, void *ptr, size_t size)
+{
+    if (ISNONZERO (ptr)) {
+        allocator->free (allocator->context, ptr, size);
+        atomic_fetch_sub_explicit (&stripe_of (allocator)->bytes, size, memory_order_relaxed);
+    }
+}
+
+struct ll_node *ll_alloc_node (const struct ll_allocator *allocator)
+{
+    struct ll_node *const node = allocator->alloc (allocator->context, sizeof *node);
+
+    if (ISNONZERO (node)) {
+        struct stripe *const stripe = stripe_of (allocator);
+
+        atomic_fetch_add_explicit (&stripe->nodes, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit (&stripe->bytes, sizeof *node, memory_order_relaxed);
+    }
+    return node;
+}
+
+void ll_free_node (const struct ll_allocator *allocator, struct ll_node *node)
+{
+    if (ISNONZERO (node)) {
+        struct stripe *const stripe = stripe_of (allocator);
+
+        allocator->free (allocator->context, node, sizeof *node);
+        atomic_fetch_sub_explicit (&stripe->nodes, 1, memory_order_relaxed);
+        atomic_fetch_sub_explicit (&stripe->bytes, sizeof *node, memory_order_relaxed);
+    }
+}
+
+bool ll_reserve (const struct ll_allocator *allocator, void **array, size_t *cap,
+                 size_t used, size_t need, size_t elem_size)
+{
+    if (need <= *cap) {
+        return true;
+    }
+
+    size_t new_cap = ISZERO (*cap) ? 16 : *cap;
+
+    while (new_cap < need) {
+        if (new_cap > SIZE_MAX / 2 / elem_size) {
+            return false;
+        }
+        new_cap *= 2;
+    }
+
+    /* The allocator interface has no realloc, hence the copy. */
+    void *const new_array = ll_alloc_bytes (allocator, new_cap * elem_size);
+
+    if (ISZERO (new_array)) {
+        return false;
+    }
+    if (ISNONZERO (used)) {
+        memcpy (new_array, *array, used * elem_size);
+    }
+    ll_free_bytes (allocator, *array, *cap * elem_size);
+    *array = new_array;
+    *cap = new_cap;
+    return true;
+}
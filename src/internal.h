@@ -0,0 +1,68 @@
+#ifndef INTERNAL_H
+#define INTERNAL_H
+
+/*  Shared between the translation units of the library, and not installed 
+*   alongside list.h. Users only ever see struct ll_node as an incomplete type.
+*/
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "list.h"
+
+#define ISNONZERO(x) ((x) != 0) 
+#define ISZERO(x) 	 ((x) == 0)
+
+/* 
+ * Data written by different threads is kept at least this far apart to avoid 
+ * false sharing.
+ */
+#define CACHE_LINE 64
+
+/* 
+ * The finalizer of SplitMix64. It spreads consecutive values, which are common,
+ * over all the bits, so that a hash table or shard can be selected by masking.
+ */
+static inline size_t ll_hash (intmax_t data)
+{
+    uint64_t x = (uint64_t) data;
+
+    x = (x ^ (x >> 30)) * UINT64_C (0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C (0x94d049bb133111eb);
+    return (size_t) (x ^ (x >> 31));
+}
+
+struct ll_node {
+    intmax_t data;
+    struct ll_node *next;
+};
+
+/*
+ * Every allocation the library makes goes through these, so that it is routed
+ * to an allocator and accounted for in it. Plain lists use the allocator in 
+ * effect for the calling thread, ll_get_allocator(); the containers use the one
+ * they were created with. ll_alloc_node() and ll_free_node() additionally 
+ * maintain the node count. The size passed to ll_free_bytes() must be the one
+ * the block was allocated with.
+ */
+struct ll_node *ll_alloc_node (const struct ll_allocator *allocator);
+void ll_free_node (const struct ll_allocator *allocator, struct ll_node *node);
+void *ll_alloc_bytes (const struct ll_allocator *allocator, size_t size);
+void ll_free_bytes (const struct ll_allocator *allocator, void *ptr, size_t size);
+
+/* 
+ * Grows *array, of *cap elements of elem_size bytes of which the first used are
+ * in use, to hold at least need elements. Capacities start at 16 and double. 
+ * On failure, the array is left as it was.
+ */
+bool ll_reserve (const struct ll_allocator *allocator, void **array, size_t *cap,
+                 size_t used, size_t need, size_t elem_size);
+
+/* 
+ * A small number identifying the calling thread, handed out round-robin on 
+ * first use and never reused. Its low bits select a stripe or shard.
+ */
+size_t ll_thread_slot (void);
+
+#endif
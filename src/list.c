@@ -5,21 +5,14 @@
 #include <assert.h>
 
 #include "list.h"
-
-#define ISNONZERO(x) ((x) != 0) 
-#define ISZERO(x) 	 ((x) == 0)
-
-struct ll_node {
-    intmax_t data;
-    struct ll_node *next;
-};
+#include "internal.h"
 
 void *ll_append_node (struct ll_node **head, intmax_t data)
 {
     while (ISNONZERO ((*head)->next)) {
         (*head) = (*head)->next;
     }
-    struct ll_node *new_node = realloc (0, sizeof *new_node);
+    struct ll_node *new_node = ll_alloc_node (ll_get_allocator ());
 
     if (ISZERO (new_node)) {
         return 0;
@@ -44,6 +37,71 @@ struct ll_node *ll_build_head (size_t size,
     return head;
 }
 
+/*
+ * The batched operations look each value of the list up in an open addressing
+ * hash table of their keys, which makes them O(n + k) rather than the O(n * k)
+ * of one pass per key. A slot holds the index of its key plus one, so that a 
+ * zero slot is free; only the first of equal keys is inserted. The table is at
+ * most half full, which keeps the linear probe sequences short.
+ */
+struct key_table {
+    size_t *slots;
+    size_t mask;
+    const intmax_t *keys;
+};
+
+static bool key_table_init (struct key_table *table, size_t size,
+                            const intmax_t keys[size])
+{
+    size_t cap = 2;
+
+    while (cap < size * 2) {
+        if (cap > SIZE_MAX / 4 / sizeof *table->slots) {
+            return false;
+        }
+        cap <<= 1;
+    }
+    table->slots = ll_alloc_bytes (ll_get_allocator (), cap * sizeof *table->slots);
+
+    if (ISZERO (table->slots)) {
+        return false;
+    }
+    table->mask = cap - 1;
+    table->keys = keys;
+
+    for (size_t i = 0; i < cap; i++) {
+        table->slots[i] = 0;
+    }
+    for (size_t i = 0; i < size; i++) {
+        size_t slot = ll_hash (keys[i]) & table->mask;
+
+        while (ISNONZERO (table->slots[slot]) && keys[table->slots[slot] - 1] != keys[i]) {
+            slot = (slot + 1) & table->mask;
+        }
+        if (ISZERO (table->slots[slot])) {
+            table->slots[slot] = i + 1;
+        }
+    }
+    return true;
+}
+
+static void key_table_free (struct key_table *table)
+{
+    ll_free_bytes (ll_get_allocator (), table->slots, (table->mask + 1) * sizeof *table->slots);
+}
+
+/* Returns the index of the first key equal to data, or SIZE_MAX if there is none. */
+static size_t key_table_find (const struct key_table *table, intmax_t data)
+{
+    for (size_t slot = ll_hash (data) & table->mask; ISNONZERO (table->slots[slot]);
+         slot = (slot + 1) & table->mask) {
+        if (table->keys[table->slots[slot] - 1] == data) {
+            return table->slots[slot] - 1;
+        }
+    }
+    return SIZE_MAX;
+}
+
 size_t ll_count_occurrence (struct ll_node **head, intmax_t data)
 {
     size_t count;
@@ -56,15 +114,48 @@ size_t ll_count_occurrence (struct ll_node **head, intmax_t data)
     return count;
 }
 
+bool ll_count_many (struct ll_node **head, size_t size,
+                    const intmax_t keys[size], size_t counts[size])
+{
+    assert (head);
+
+    struct key_table table;
+
+    if (ISZERO (size)) {
+        return true;
+    }
+    if (!key_table_init (&table, size, keys)) {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        counts[i] = 0;
+    }
+    for (; ISNONZERO (*head); head = &(*head)->next) {
+        size_t const i = key_table_find (&table, (*head)->data);
+
+        if (i != SIZE_MAX) {
+            counts[i]++;
+        }
+    }
+    /* Only the first of equal keys was counted; copy its count to the others. */
+    for (size_t i = 0; i < size; i++) {
+        counts[i] = counts[key_table_find (&table, keys[i])];
+    }
+    key_table_free (&table);
+    return true;
+}
+
 void ll_delete (struct ll_node **head)
 {
     assert (head);
 
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+
     while (ISNONZERO (*head)) {
         struct ll_node *current = *head;
 
         *head = (*head)->next;
-        free (current);
+        ll_free_node (allocator, current);
     }
 }
 
@@ -125,7 +216,7 @@ bool ll_insert_pos (struct ll_node **head, size_t index,
     while (ISNONZERO (current) && count++ < index) {
         current = current->next;
     }
-    struct ll_node *new_node = realloc (0, sizeof *new_node);
+    struct ll_node *new_node = ll_alloc_node (ll_get_allocator ());
 
     if (ISZERO (new_node)) {
         return false;
@@ -140,7 +231,7 @@ bool ll_push_node (struct ll_node **head, intmax_t data)
 {
     assert (head);
 
-    struct ll_node *new_node = realloc (0, sizeof *new_node);
+    struct ll_node *new_node = ll_alloc_node (ll_get_allocator ());
 
     if (ISZERO (new_node)) {
         return false;
@@ -175,7 +266,7 @@ intmax_t ll_pop_node (struct ll_node **head)
     intmax_t data = current->data;
 
     *head = current->next;
-    free (current);
+    ll_free_node (ll_get_allocator (), current);
 
     return data;
 
@@ -195,7 +286,7 @@ intmax_t ll_pop_end (struct ll_node **head)
     prev->next = current->next;
     intmax_t result = current->data;
 
-    free (current);
+    ll_free_node (ll_get_allocator (), current);
     return result;
 }
 
@@ -223,7 +314,7 @@ intmax_t ll_pop_pos (struct ll_node **head, size_t index)
     prev->next = current->next;
     intmax_t result = current->data;
 
-    free (current);
+    ll_free_node (ll_get_allocator (), current);
     return result;
 }
 
@@ -231,12 +322,14 @@ void ll_remove (struct ll_node **head, intmax_t data)
 {
     assert (head && *head);
 
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+
     while (ISNONZERO (*head)) {
         if ((*head)->data == data) {
             struct ll_node *tmp = *head;
 
             *head = (*head)->next;
-            free (tmp);
+            ll_free_node (allocator, tmp);
         } else {
             head = &(*head)->next;
         }
@@ -247,12 +340,14 @@ void ll_remove_dup (struct ll_node **head)
 {
     assert (head && *head);
 
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+
     while (ISNONZERO ((*head)->next)) {
         if ((*head)->data == (*head)->next->data) {
             struct ll_node *dup = (*head)->next;
 
             (*head)->next = (*head)->next->next;
-            free (dup);
+            ll_free_node (allocator, dup);
         }
         head = &(*head)->next;
     }
@@ -263,16 +358,47 @@ void ll_remove_if (struct ll_node **head,
 {
     assert (head && *head);
 
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+
     while (ISNONZERO (*head)) {
         if (predicate ((*head)->data)) {
             struct ll_node *tmp = *head;
 
             *head = (*head)->next;
-            free (tmp);
+            ll_free_node (allocator, tmp);
+        } else {
+            head = &(*head)->next;
+        }
+    }
+}
+
+bool ll_remove_set (struct ll_node **head, size_t size,
+                    const intmax_t keys[size])
+{
+    assert (head);
+
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+
+    struct key_table table;
+
+    if (ISZERO (size)) {
+        return true;
+    }
+    if (!key_table_init (&table, size, keys)) {
+        return false;
+    }
+    while (ISNONZERO (*head)) {
+        if (key_table_find (&table, (*head)->data) != SIZE_MAX) {
+            struct ll_node *tmp = *head;
+
+            *head = (*head)->next;
+            ll_free_node (allocator, tmp);
         } else {
             head = &(*head)->next;
         }
     }
+    key_table_free (&table);
+    return true;
 }
 
 void ll_replace_node (struct ll_node **head, intmax_t old_data,
@@ -288,6 +414,49 @@ void ll_replace_node (struct ll_node **head, intmax_t old_data,
     }
 }
 
+bool ll_replace_map (struct ll_node **head, size_t size,
+                     const intmax_t old_data[size],
+                     const intmax_t new_data[size])
+{
+    assert (head);
+
+    struct key_table table;
+
+    if (ISZERO (size)) {
+        return true;
+    }
+    if (!key_table_init (&table, size, old_data)) {
+        return false;
+    }
+
+    bool *const done = ll_alloc_bytes (ll_get_allocator (), size * sizeof *done);
+
+    if (ISZERO (done)) {
+        key_table_free (&table);
+        return false;
+    }
+
+    /* Duplicate keys are never looked up, so they count as done from the start. */
+    size_t pending = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        done[i] = key_table_find (&table, old_data[i]) != i;
+        pending += !done[i];
+    }
+    for (; ISNONZERO (*head) && ISNONZERO (pending); head = &(*head)->next) {
+        size_t const i = key_table_find (&table, (*head)->data);
+
+        if (i != SIZE_MAX && !done[i]) {
+            (*head)->data = new_data[i];
+            done[i] = true;
+            pending--;
+        }
+    }
+    ll_free_bytes (ll_get_allocator (), done, size * sizeof *done);
+    key_table_free (&table);
+    return true;
+}
+
 void ll_reverse (struct ll_node **head)
 {
     assert (head && *head);
@@ -1,5 +1,5 @@
 #ifndef LIST_H
-#define LISH_H 
+#define LIST_H 
 
 /*  The header is meant for users of the code. So in there I document the interface: 
 *   how to use it, preconditions and postconditions, etcetera.
@@ -8,8 +8,116 @@
 *   how things work internally, and why they work that way.
 */
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
 struct ll_node;
 
+/**
+*	@brief	 The counters the library keeps for an allocator. Opaque.
+*/
+struct ll_allocator_stats;
+
+/**
+*	@brief	 An ll_allocator routes the memory of the library to a user supplied 
+*			 allocator, and keeps count of what is currently allocated through it.
+*	@member	 alloc - Shall return a pointer to at least size bytes, or a NULL 
+*					 pointer to indicate failure.
+*	@member	 free - Shall release ptr, which was obtained from alloc with the 
+*					same size. ptr is never a NULL pointer.
+*	@member	 context - Passed through unmodified to alloc and free.
+*	@member	 stats - Set by ll_allocator_init() and cleared by 
+*					 ll_allocator_destroy(). Shall not be touched otherwise.
+*
+*	An allocator is used by the library in one of three ways:
+*	- Process-wide, once installed with ll_set_default_allocator().
+*	- By a single thread, which overrides the process-wide one with 
+*	  ll_set_allocator().
+*	- By a container - ll_sharded, ll_queue, ll_packed, ll_view and ll_spill -
+*	  which owns the allocator in effect when it was created, and uses it for
+*	  all of its memory from then on, whichever thread calls it.
+*
+*	Plain lists of struct ll_node have no owner: every call allocates and frees
+*	through the allocator in effect for the calling thread, as returned by 
+*	ll_get_allocator(). There is no per-list allocator for them; a list shall
+*	only be modified or deleted where the allocator it was built with is in
+*	effect.
+*/
+struct ll_allocator {
+    void *(*alloc) (void *context, size_t size);
+    void (*free) (void *context, void *ptr, size_t size);
+    void *context;
+    struct ll_allocator_stats *stats;
+};
+
+/**
+*	@brief	 A snapshot of the live allocations of an allocator.
+*	@member	 nodes - The number of list nodes currently allocated.
+*	@member	 bytes - The number of bytes currently allocated, nodes included.
+*/
+struct ll_memory_usage {
+    size_t nodes;
+    size_t bytes;
+};
+
+/**
+*	@brief	 ll_allocator_init() shall prepare allocator for use, with all its 
+*			 counters at 0. alloc and free shall already be set.
+*	@param	 allocator - A pointer to the allocator.
+*	@return	 Upon successful return, ll_allocator_init() returns true. Otherwise, 
+*			 it returns false to indicate a memory allocation failure.
+*/
+bool ll_allocator_init (struct ll_allocator *allocator);
+
+/**
+*	@brief	 ll_allocator_destroy() shall release what ll_allocator_init() 
+*			 allocated. allocator shall no longer be in effect anywhere, and all
+*			 the memory allocated through it shall have been freed.
+*	@param	 allocator - A pointer to the allocator.
+*	@return	 This function returns nothing.
+*/
+void ll_allocator_destroy (struct ll_allocator *allocator);
+
+/**
+*	@brief	 ll_set_default_allocator() shall install allocator for all threads
+*			 that have not installed one of their own with ll_set_allocator().
+*	@param	 allocator - A pointer to an initialized allocator. If allocator is 
+*						 a NULL pointer, the built-in allocator, built on 
+*						 realloc() and free(), is reinstalled.
+*	@return	 This function returns nothing.
+*	@warning The allocator shall be thread-safe. Lists built by threads using 
+*			 the process-wide allocator shall not outlive a change of it.
+*/
+void ll_set_default_allocator (const struct ll_allocator *allocator);
+
+/**
+*	@brief	 ll_set_allocator() shall install allocator for the calling thread 
+*			 only, overriding the process-wide one.
+*	@param	 allocator - A pointer to an initialized allocator. If allocator is 
+*						 a NULL pointer, the override is removed, and the thread
+*						 uses the process-wide allocator again.
+*	@return	 This function returns nothing.
+*/
+void ll_set_allocator (const struct ll_allocator *allocator);
+
+/**
+*	@brief	 ll_get_allocator() shall return the allocator in effect for the 
+*			 calling thread: its own if it has installed one, and the 
+*			 process-wide one otherwise.
+*	@return	 A pointer to the allocator. This is never a NULL pointer.
+*/
+const struct ll_allocator *ll_get_allocator (void);
+
+/**
+*	@brief	 ll_memory_usage() shall report the memory currently allocated through 
+*			 allocator, by all threads and containers.
+*	@param	 allocator - A pointer to an initialized allocator. If allocator is
+*						 a NULL pointer, the built-in allocator is queried.
+*	@return	 The number of live nodes and bytes allocated through allocator.
+*/
+struct ll_memory_usage ll_memory_usage (const struct ll_allocator *allocator);
+
 /** 
 *	@brief   ll_append_node() shall append a new node just before the given list 
 *			 head - to the end of the list, in other words. ll_append_node() can 
@@ -64,6 +172,23 @@ struct ll_node *ll_build_tail (size_t size,
 */
 size_t ll_count_occurrence (struct ll_node **head, intmax_t data);
 
+/**
+*	@brief	 ll_count_many() shall count the number of occurrences of each of 
+*			 keys in the list, in a single pass over it.
+*	@param	 head - A double pointer to the head of the list. Allows *head to be
+*					NULL.
+*	@param	 size - The number of keys.
+*	@param	 keys[size] - The values to search for. A key may appear more than
+*						  once, in which case each of its elements of counts
+*						  receives the same count.
+*	@param	 counts[size] - The array to store the count of each key in.
+*	@return	 Upon successful return, ll_count_many() returns true. Otherwise, it
+*			 returns false to indicate a memory allocation failure, in which 
+*			 case counts is left unspecified.
+*/
+bool ll_count_many (struct ll_node **head, size_t size,
+                    const intmax_t keys[size], size_t counts[size]);
+
 /**
 *	@brief	 ll_delete() shall free all the items in the list. Allows head to be NULL
 *			 to mimic free (NULL), in which case no operation is performed.
@@ -235,6 +360,21 @@ void ll_remove_dup (struct ll_node **head);
 void ll_remove_if (struct ll_node **head,
                           bool (*predicate) (intmax_t data));
 
+/**
+*	@brief	 ll_remove_set() shall remove all nodes that match any of keys, in a
+*			 single pass over the list. It is equivalent to, but faster than, 
+*			 calling ll_remove() once per key.
+*	@param	 head - A double pointer to the head of the list. Allows *head to be
+*					NULL.
+*	@param	 size - The number of keys.
+*	@param	 keys[size] - The values to remove.
+*	@return	 Upon successful return, ll_remove_set() returns true. Otherwise, it
+*			 returns false to indicate a memory allocation failure, in which 
+*			 case the list is left unchanged.
+*/
+bool ll_remove_set (struct ll_node **head, size_t size,
+                    const intmax_t keys[size]);
+
 /** 
 *	@brief   ll_replace_node() shall update the value of the item of the first
 *			 node that matches the value of old_data. No operation is performed if
@@ -249,6 +389,26 @@ void ll_remove_if (struct ll_node **head,
 */
 void ll_replace_node (struct ll_node **head, intmax_t old_data,
                              intmax_t new_data);
+
+/**
+*	@brief	 ll_replace_map() shall, for each pair old_data[i] and new_data[i], 
+*			 update the value of the item of the first node that matches 
+*			 old_data[i] to new_data[i], in a single pass over the list. Nodes
+*			 are matched against the values they held before the call, so a 
+*			 replaced value is never replaced again. If old_data holds the 
+*			 same value more than once, the first pair wins.
+*	@param	 head - A double pointer to the head of the list. Allows *head to be
+*					NULL.
+*	@param	 size - The number of pairs.
+*	@param	 old_data[size] - The values of the items to update.
+*	@param	 new_data[size] - The new values to initialize the items with.
+*	@return	 Upon successful return, ll_replace_map() returns true. Otherwise, 
+*			 it returns false to indicate a memory allocation failure, in which
+*			 case the list is left unchanged.
+*/
+bool ll_replace_map (struct ll_node **head, size_t size,
+                     const intmax_t old_data[size],
+                     const intmax_t new_data[size]);
 /**
 *	@brief	 ll_reverse() shall reverse the list pointed to by head. 
 *	@param	 head - A double pointer to the head of the list.
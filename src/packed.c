@@ -0,0 +1,290 @@
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "packed.h"
+#include "internal.h"
+
+/*
+ * The payload of every block is kept back to back in one byte array, and the
+ * block headers in another, so that a list costs two allocations however long
+ * it grows. Only the last block is ever appended to, so a block's payload 
+ * simply ends where the next one's begins.
+ *
+ * A block stores its first item in min, and each following item as its 
+ * difference from the previous one, in LEB128: seven bits per byte, least 
+ * significant group first, the high bit set on all but the last byte. Since the
+ * items are sorted the differences are never negative, and a gap below 128 
+ * costs a single byte. The arithmetic is done in uintmax_t, where it wraps, as 
+ * the difference between two intmax_t may not fit in one.
+ *
+ * BLOCK_ITEMS trades the header overhead (sizeof (struct block) / BLOCK_ITEMS 
+ * bytes per item) against the number of items decoded to find one.
+ */
+#define BLOCK_ITEMS     128
+#define MAX_VARINT_SIZE ((sizeof (uintmax_t) * CHAR_BIT + 6) / 7)
+
+struct block {
+    intmax_t min;
+    intmax_t max;
+    size_t offset;
+    size_t count;
+};
+
+struct ll_packed {
+    const struct ll_allocator *allocator;
+    struct block *blocks;
+    size_t nblocks;
+    size_t block_cap;
+    unsigned char *bytes;
+    size_t nbytes;
+    size_t byte_cap;
+    size_t size;
+};
+
+struct ll_packed *ll_packed_create (void)
+{
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+    struct ll_packed *const packed = ll_alloc_bytes (allocator, sizeof *packed);
+
+    if (ISNONZERO (packed)) {
+        *packed = (struct ll_packed) { .allocator = allocator };
+    }
+    return packed;
+}
+
+struct ll_packed *ll_packed_from_list (struct ll_node *const *head)
+{
+    assert (head);
+
+    struct ll_packed *packed = ll_packed_create ();
+
+    if (ISZERO (packed)) {
+        return 0;
+    }
+    for (const struct ll_node *node = *head; ISNONZERO (node); node = node->next) {
+        if (!ll_packed_append (packed, node->data)) {
+            ll_packed_delete (&packed);
+            return 0;
+        }
+    }
+    return packed;
+}
+
+void ll_packed_delete (struct ll_packed **packed)
+{
+    assert (packed);
+
+    if (ISNONZERO (*packed)) {
+        const struct ll_allocator *const allocator = (*packed)->allocator;
+
+        ll_free_bytes (allocator, (*packed)->blocks, (*packed)->block_cap * sizeof *(*packed)->blocks);
+        ll_free_bytes (allocator, (*packed)->bytes, (*packed)->byte_cap);
+        ll_free_bytes (allocator, *packed, sizeof **packed);
+        *packed = 0;
+    }
+}
+
+bool ll_packed_append (struct ll_packed *packed, intmax_t data)
+{
+    assert (packed);
+
+    struct block *last = ISZERO (packed->nblocks) ? 0 : &packed->blocks[packed->nblocks - 1];
+
+    if (ISNONZERO (last) && data < last->max) {
+        return false;
+    }
+    if (ISZERO (last) || last->count == BLOCK_ITEMS) {
+        void *blocks = packed->blocks;
+
+        if (!ll_reserve (packed->allocator, &blocks, &packed->block_cap,
+                         packed->nblocks, packed->nblocks + 1,
+                         sizeof *packed->blocks)) {
+            return false;
+        }
+        packed->blocks = blocks;
+        packed->blocks[packed->nblocks++] = (struct block) {
+            .min = data,
+            .max = data,
+            .offset = packed->nbytes,
+            .count = 1,
+        };
+        packed->size++;
+        return true;
+    }
+
+    void *bytes = packed->bytes;
+
+    if (!ll_reserve (packed->allocator, &bytes, &packed->byte_cap,
+                     packed->nbytes, packed->nbytes + MAX_VARINT_SIZE, 1)) {
+        return false;
+    }
+    packed->bytes = bytes;
+
+    uintmax_t delta = (uintmax_t) data - (uintmax_t) last->max;
+
+    while (delta >= 0x80) {
+        packed->bytes[packed->nbytes++] = (unsigned char) (delta | 0x80);
+        delta >>= 7;
+    }
+    packed->bytes[packed->nbytes++] = (unsigned char) delta;
+    last->max = data;
+    last->count++;
+    packed->size++;
+    return true;
+}
+
+size_t ll_packed_size (const struct ll_packed *packed)
+{
+    assert (packed);
+    return packed->size;
+}
+
+static uintmax_t read_varint (const unsigned char *bytes, size_t *pos)
+{
+    uintmax_t value = 0;
+    unsigned shift = 0;
+    unsigned char byte;
+
+    do {
+        byte = bytes[(*pos)++];
+        value |= (uintmax_t) (byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+/* 
+ * Returns the index of the first block whose max is not less than data, which
+ * is the only place data can start. The maxima are sorted, as the items are.
+ */
+static size_t find_block (const struct ll_packed *packed, intmax_t data)
+{
+    size_t lo = 0;
+    size_t hi = packed->nblocks;
+
+    while (lo < hi) {
+        size_t const mid = lo + (hi - lo) / 2;
+
+        if (packed->blocks[mid].max < data) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* Counts the occurrences of data in a block by decoding it. */
+static size_t count_block (const struct ll_packed *packed,
+                           const struct block *block, intmax_t data)
+{
+    size_t pos = block->offset;
+    intmax_t value = block->min;
+    size_t count = value == data;
+
+    for (size_t i = 1; i < block->count && value <= data; i++) {
+        value = (intmax_t) ((uintmax_t) value + read_varint (packed->bytes, &pos));
+        count += value == data;
+    }
+    return count;
+}
+
+bool ll_packed_is_containing (const struct ll_packed *packed, intmax_t data)
+{
+    assert (packed);
+
+    size_t const i = find_block (packed, data);
+
+    if (i == packed->nblocks || packed->blocks[i].min > data) {
+        return false;
+    }
+    return packed->blocks[i].max == data 
+           || count_block (packed, &packed->blocks[i], data) > 0;
+}
+
+size_t ll_packed_count_occurrence (const struct ll_packed *packed, intmax_t data)
+{
+    assert (packed);
+
+    size_t count = 0;
+
+    for (size_t i = find_block (packed, data);
+         i < packed->nblocks && packed->blocks[i].min <= data; i++) {
+        const struct block *const block = &packed->blocks[i];
+
+        if (block->min == data && block->max == data) {
+            count += block->count;
+        } else {
+            count += count_block (packed, block, data);
+        }
+    }
+    return count;
+}
+
+size_t ll_packed_decode (const struct ll_packed *packed, size_t size,
+                         intmax_t data[size])
+{
+    assert (packed && (data || ISZERO (size)));
+
+    size_t n = 0;
+
+    for (size_t i = 0; i < packed->nblocks && n < size; i++) {
+        const struct block *const block = &packed->blocks[i];
+        size_t pos = block->offset;
+        intmax_t value = block->min;
+
+        data[n++] = value;
+        for (size_t j = 1; j < block->count && n < size; j++) {
+            value = (intmax_t) ((uintmax_t) value + read_varint (packed->bytes, &pos));
+            data[n++] = value;
+        }
+    }
+    return n;
+}
+
+void ll_packed_iter_init (struct ll_packed_iter *iter,
+                          const struct ll_packed *packed)
+{
+    assert (iter && packed);
+    *iter = (struct ll_packed_iter) { .packed = packed };
+}
+
+bool ll_packed_next (struct ll_packed_iter *iter, intmax_t *data)
+{
+    assert (iter && data);
+
+    const struct ll_packed *const packed = iter->packed;
+
+    if (ISZERO (iter->remaining)) {
+        if (iter->block == packed->nblocks) {
+            return false;
+        }
+
+        const struct block *const block = &packed->blocks[iter->block++];
+
+        iter->value = block->min;
+        iter->pos = block->offset;
+        iter->remaining = block->count - 1;
+    } else {
+        iter->value = (intmax_t) ((uintmax_t) iter->value + read_varint (packed->bytes, &iter->pos));
+        iter->remaining--;
+    }
+    *data = iter->value;
+    return true;
+}
+
+size_t ll_packed_memory (const struct ll_packed *packed, double *per_item)
+{
+    assert (packed);
+
+    size_t const bytes = sizeof *packed 
+                         + packed->block_cap * sizeof *packed->blocks 
+                         + packed->byte_cap;
+
+    if (ISNONZERO (per_item)) {
+        *per_item = ISZERO (packed->size) ? 0 : (double) bytes / (double) packed->size;
+    }
+    return bytes;
+}
@@ -0,0 +1,138 @@
+#ifndef PACKED_H
+#define PACKED_H
+
+/*  A compressed, read-mostly representation of a list of intmax_t sorted in
+*   non-decreasing order. Items are stored in blocks: each block keeps its 
+*   smallest and largest item, and the gaps between consecutive items as 
+*   variable-length integers, so that a list of closely spaced values costs
+*   little more than a byte per item instead of a node per item.
+*
+*   Items can only be appended in order; there are no mid-list edits.
+*/
+
+#include "list.h"
+
+struct ll_packed;
+
+/**
+*	@brief	 An iterator over the items of an ll_packed. It is only valid while 
+*			 the list is not appended to. Its members are private: initialize
+*			 it with ll_packed_iter_init() and advance it with ll_packed_next().
+*/
+struct ll_packed_iter {
+    const struct ll_packed *packed;
+    size_t block;
+    size_t pos;
+    size_t remaining;
+    intmax_t value;
+};
+
+/**
+*	@brief	 ll_packed_create() shall create an empty compressed list.
+*	@return	 Upon successful return, ll_packed_create() shall return a pointer 
+*			 to the new list. Otherwise, it shall return a NULL pointer to 
+*			 indicate a memory allocation failure.
+*/
+struct ll_packed *ll_packed_create (void);
+
+/**
+*	@brief	 ll_packed_from_list() shall create a compressed list holding the 
+*			 items of the list pointed to by head, which is left unchanged.
+*	@param	 head - A double pointer to the head of a list sorted in 
+*					non-decreasing order. Allows *head to be NULL.
+*	@return	 Upon successful return, ll_packed_from_list() shall return a pointer
+*			 to the new list. Otherwise, it shall return a NULL pointer to 
+*			 indicate a memory allocation failure, or that the list is not 
+*			 sorted.
+*/
+struct ll_packed *ll_packed_from_list (struct ll_node *const *head);
+
+/**
+*	@brief	 ll_packed_delete() shall free the list. Allows *packed to be NULL, 
+*			 in which case no operation is performed.
+*	@param	 packed - A double pointer to the list. *packed is set to NULL.
+*	@return	 This function returns nothing.
+*/
+void ll_packed_delete (struct ll_packed **packed);
+
+/**
+*	@brief	 ll_packed_append() shall append data to the end of the list.
+*	@param	 packed - A pointer to the list.
+*	@param	 data - The value to append. It shall not be less than the last
+*					item of the list.
+*	@return	 Upon successful return, ll_packed_append() returns true. Otherwise
+*			 it returns false to indicate a memory allocation failure, or that
+*			 data would break the order of the list, in which case nothing is 
+*			 appended.
+*/
+bool ll_packed_append (struct ll_packed *packed, intmax_t data);
+
+/**
+*	@brief	 ll_packed_size() shall return the number of items in the list.
+*	@param	 packed - A pointer to the list.
+*	@return	 The number of items present. This takes constant time.
+*/
+size_t ll_packed_size (const struct ll_packed *packed);
+
+/**
+*	@brief	 ll_packed_is_containing() shall search the list for data. Only the 
+*			 block whose range covers data is decoded.
+*	@param	 packed - A pointer to the list.
+*	@param	 data - The value to search for.
+*	@return	 ll_packed_is_containing() returns true if data was found. Otherwise
+*			 it returns false.
+*/
+bool ll_packed_is_containing (const struct ll_packed *packed, intmax_t data);
+
+/**
+*	@brief	 ll_packed_count_occurrence() shall count the number of occurrences 
+*			 of data in the list. Blocks that hold nothing but data are counted
+*			 without being decoded.
+*	@param	 packed - A pointer to the list.
+*	@param	 data - The value to search for.
+*	@return	 The count of the number of occurrences of data.
+*/
+size_t ll_packed_count_occurrence (const struct ll_packed *packed, intmax_t data);
+
+/**
+*	@brief	 ll_packed_decode() shall decode the first items of the list into 
+*			 an array.
+*	@param	 packed - A pointer to the list.
+*	@param	 size - The number of elements of data.
+*	@param	 data[size] - The array to decode into.
+*	@return	 The number of items decoded, which is the lesser of size and the
+*			 size of the list.
+*/
+size_t ll_packed_decode (const struct ll_packed *packed, size_t size,
+                         intmax_t data[size]);
+
+/**
+*	@brief	 ll_packed_iter_init() shall position iter before the first item of
+*			 the list.
+*	@param	 iter - A pointer to the iterator to initialize.
+*	@param	 packed - A pointer to the list to iterate over.
+*	@return	 This function returns nothing.
+*/
+void ll_packed_iter_init (struct ll_packed_iter *iter,
+                          const struct ll_packed *packed);
+
+/**
+*	@brief	 ll_packed_next() shall advance iter to the next item of the list.
+*	@param	 iter - A pointer to an initialized iterator.
+*	@param	 data - A pointer to store the value of the item in.
+*	@return	 ll_packed_next() returns true if there was a next item. Otherwise,
+*			 it returns false, and leaves *data untouched.
+*/
+bool ll_packed_next (struct ll_packed_iter *iter, intmax_t *data);
+
+/**
+*	@brief	 ll_packed_memory() shall report the memory held by the list.
+*	@param	 packed - A pointer to the list.
+*	@param	 per_item - An optional pointer to store the average number of bytes
+*						per item in. 0 is stored for an empty list.
+*	@return	 The number of bytes allocated for the list, including unused 
+*			 capacity.
+*/
+size_t ll_packed_memory (const struct ll_packed *packed, double *per_item);
+
+#endif
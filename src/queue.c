@@ -0,0 +1,226 @@
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+#include "queue.h"
+#include "internal.h"
+
+/*
+ * head and tail are free-running counters; an index into items is obtained by
+ * masking, which is why the capacity is a power of two. The queue is empty when
+ * head == tail and full when tail - head == capacity, so all of the slots are 
+ * usable. Unsigned wrap-around keeps the difference correct.
+ *
+ * The same code serves both modes. In LL_QUEUE_SPSC mode, the producer owns 
+ * tail and the consumer owns head: each publishes its counter with a release 
+ * store and reads the other's with an acquire load, so that an item is written
+ * before it becomes visible and read before its slot is reused. Each side also 
+ * caches the last value it saw of the other's counter, and only reloads it when
+ * the cached one says the queue is full (or empty), which keeps the cache line 
+ * of the other side from bouncing on every operation.
+ *
+ * The padding keeps the producer's and consumer's data on separate cache lines.
+ * It is not aligned to one, as the allocator only guarantees malloc() alignment,
+ * but CACHE_LINE bytes of separation suffice.
+ */
+struct ll_queue {
+    const struct ll_allocator *allocator;
+    intmax_t *items;
+    size_t mask;
+    enum ll_queue_mode mode;
+    char pad0[CACHE_LINE];
+    atomic_size_t head;
+    size_t tail_cache;
+    char pad1[CACHE_LINE];
+    atomic_size_t tail;
+    size_t head_cache;
+    char pad2[CACHE_LINE];
+};
+
+/* The largest capacity whose items array is still representable in size_t. */
+#define MAX_CAPACITY (SIZE_MAX / 2 / sizeof (intmax_t))
+
+struct ll_queue *ll_queue_create (size_t capacity, enum ll_queue_mode mode)
+{
+    if (capacity > MAX_CAPACITY) {
+        return 0;
+    }
+
+    size_t cap = 1;
+
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+    struct ll_queue *const queue = ll_alloc_bytes (allocator, sizeof *queue);
+
+    if (ISZERO (queue)) {
+        return 0;
+    }
+    queue->allocator = allocator;
+    queue->items = ll_alloc_bytes (allocator, cap * sizeof *queue->items);
+
+    if (ISZERO (queue->items)) {
+        ll_free_bytes (allocator, queue, sizeof *queue);
+        return 0;
+    }
+    queue->mask = cap - 1;
+    queue->mode = mode;
+    queue->tail_cache = queue->head_cache = 0;
+    atomic_init (&queue->head, 0);
+    atomic_init (&queue->tail, 0);
+    return queue;
+}
+
+void ll_queue_delete (struct ll_queue **queue)
+{
+    assert (queue);
+
+    if (ISNONZERO (*queue)) {
+        const struct ll_allocator *const allocator = (*queue)->allocator;
+
+        ll_free_bytes (allocator, (*queue)->items, ((*queue)->mask + 1) * sizeof *(*queue)->items);
+        ll_free_bytes (allocator, *queue, sizeof **queue);
+        *queue = 0;
+    }
+}
+
+/* 
+ * Only reachable in LL_QUEUE_GROWABLE mode, where no other thread may be using
+ * the queue. The items are unwrapped to the start of the new array.
+ */
+static bool grow (struct ll_queue *queue)
+{
+    size_t const cap = queue->mask + 1;
+
+    if (cap > MAX_CAPACITY / 2) {
+        return false;
+    }
+
+    intmax_t *const items = ll_alloc_bytes (queue->allocator, 2 * cap * sizeof *items);
+
+    if (ISZERO (items)) {
+        return false;
+    }
+
+    size_t const head = atomic_load_explicit (&queue->head, memory_order_relaxed);
+    size_t const first = head & queue->mask;
+
+    /* The queue is full, so the items are [first, cap) followed by [0, first). */
+    memcpy (items, queue->items + first, (cap - first) * sizeof *items);
+    memcpy (items + (cap - first), queue->items, first * sizeof *items);
+    ll_free_bytes (queue->allocator, queue->items, cap * sizeof *items);
+
+    queue->items = items;
+    queue->mask = 2 * cap - 1;
+    queue->head_cache = queue->tail_cache = 0;
+    atomic_store_explicit (&queue->head, 0, memory_order_relaxed);
+    atomic_store_explicit (&queue->tail, cap, memory_order_relaxed);
+    return true;
+}
+
+bool ll_queue_enqueue (struct ll_queue *queue, intmax_t data)
+{
+    assert (queue);
+
+    size_t tail = atomic_load_explicit (&queue->tail, memory_order_relaxed);
+
+    if (tail - queue->head_cache > queue->mask) {
+        queue->head_cache = atomic_load_explicit (&queue->head, memory_order_acquire);
+
+        if (tail - queue->head_cache > queue->mask) {
+            if (queue->mode == LL_QUEUE_SPSC || !grow (queue)) {
+                return false;
+            }
+            tail = atomic_load_explicit (&queue->tail, memory_order_relaxed);
+        }
+    }
+    queue->items[tail & queue->mask] = data;
+    atomic_store_explicit (&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool ll_queue_dequeue (struct ll_queue *queue, intmax_t *data)
+{
+    assert (queue && data);
+
+    size_t const head = atomic_load_explicit (&queue->head, memory_order_relaxed);
+
+    if (head == queue->tail_cache) {
+        queue->tail_cache = atomic_load_explicit (&queue->tail, memory_order_acquire);
+
+        if (head == queue->tail_cache) {
+            return false;
+        }
+    }
+    *data = queue->items[head & queue->mask];
+    atomic_store_explicit (&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+size_t ll_queue_size (const struct ll_queue *queue)
+{
+    assert (queue);
+
+    /* 
+     * head is loaded first: tail only ever grows, so it can not be seen behind
+     * it.
+     */
+    size_t const head = atomic_load_explicit (&queue->head, memory_order_acquire);
+    size_t const tail = atomic_load_explicit (&queue->tail, memory_order_acquire);
+
+    return tail - head;
+}
+
+size_t ll_queue_capacity (const struct ll_queue *queue)
+{
+    assert (queue);
+    return queue->mask + 1;
+}
+
+bool ll_queue_append_list (struct ll_queue *queue, struct ll_node *const *head)
+{
+    assert (queue && head);
+
+    for (struct ll_node *node = *head; ISNONZERO (node); node = node->next) {
+        if (!ll_queue_enqueue (queue, node->data)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ll_queue_to_list (struct ll_queue *queue, struct ll_node **head)
+{
+    assert (queue && head);
+
+    size_t const first = atomic_load_explicit (&queue->head, memory_order_relaxed);
+    size_t const last = atomic_load_explicit (&queue->tail, memory_order_acquire);
+    struct ll_node *list = 0;
+    struct ll_node **tail = &list;
+
+    /* 
+     * The nodes are built before head is advanced, so that on failure the
+     * queue can be left as it was. They make up a plain list, so they come 
+     * from the allocator of the calling thread, not that of the queue.
+     */
+    for (size_t i = first; i != last; i++) {
+        struct ll_node *const new_node = ll_alloc_node (ll_get_allocator ());
+
+        if (ISZERO (new_node)) {
+            ll_delete (&list);
+            return false;
+        }
+        new_node->data = queue->items[i & queue->mask];
+        new_node->next = 0;
+        *tail = new_node;
+        tail = &new_node->next;
+    }
+    queue->tail_cache = last;
+    atomic_store_explicit (&queue->head, last, memory_order_release);
+    *head = list;
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+/*  A first-in first-out queue of intmax_t backed by a ring buffer, for when the
+*   ll_append_node() and ll_pop_node() pair is all that is asked of a list. 
+*   Enqueueing and dequeueing are O(1) (amortized, if the queue has to grow), 
+*   and no memory is allocated per item.
+*/
+
+#include "list.h"
+
+struct ll_queue;
+
+/**
+*	@brief	 Selects the behaviour of a queue when it is full, and which threads 
+*			 may use it.
+*	@value	 LL_QUEUE_GROWABLE - The capacity is doubled as needed. The queue
+*								 shall only be used by one thread at a time.
+*	@value	 LL_QUEUE_SPSC - The capacity is fixed. One producer thread may 
+*							 enqueue while one consumer thread dequeues, 
+*							 without locking.
+*/
+enum ll_queue_mode {
+    LL_QUEUE_GROWABLE,
+    LL_QUEUE_SPSC,
+};
+
+/**
+*	@brief	 ll_queue_create() shall create an empty queue.
+*	@param	 capacity - The initial number of items the queue can hold. It is 
+*						rounded up to a power of two, and to at least 1.
+*	@param	 mode - Whether the queue grows, or is a bounded single-producer
+*					single-consumer queue.
+*	@return	 Upon successful return, ll_queue_create() shall return a pointer
+*			 to the new queue. Otherwise, it shall return a NULL pointer to 
+*			 indicate failure.
+*/
+struct ll_queue *ll_queue_create (size_t capacity, enum ll_queue_mode mode);
+
+/**
+*	@brief	 ll_queue_delete() shall free the queue. Allows *queue to be NULL, in
+*			 which case no operation is performed.
+*	@param	 queue - A double pointer to the queue. *queue is set to NULL.
+*	@return	 This function returns nothing.
+*/
+void ll_queue_delete (struct ll_queue **queue);
+
+/**
+*	@brief	 ll_queue_enqueue() shall add data to the back of the queue. In 
+*			 LL_QUEUE_SPSC mode, only the producer thread may call it.
+*	@param	 queue - A pointer to the queue.
+*	@param	 data - The value of the item to add.
+*	@return	 Upon successful return, ll_queue_enqueue() returns true. Otherwise
+*			 it returns false to indicate an allocation failure, or in 
+*			 LL_QUEUE_SPSC mode, that the queue is full.
+*/
+bool ll_queue_enqueue (struct ll_queue *queue, intmax_t data);
+
+/**
+*	@brief	 ll_queue_dequeue() shall remove the item at the front of the queue. 
+*			 In LL_QUEUE_SPSC mode, only the consumer thread may call it.
+*	@param	 queue - A pointer to the queue.
+*	@param	 data - A pointer to store the value of the removed item in.
+*	@return	 Upon successful return, ll_queue_dequeue() returns true. Otherwise 
+*			 it returns false to indicate that the queue is empty, in which case
+*			 *data is left untouched.
+*/
+bool ll_queue_dequeue (struct ll_queue *queue, intmax_t *data);
+
+/**
+*	@brief	 ll_queue_size() shall return the number of items in the queue. In
+*			 LL_QUEUE_SPSC mode, the result may be stale by the time it is used.
+*	@param	 queue - A pointer to the queue.
+*	@return	 The number of items in the queue.
+*/
+size_t ll_queue_size (const struct ll_queue *queue);
+
+/**
+*	@brief	 ll_queue_capacity() shall return the number of items the queue can
+*			 hold before it has to grow, or in LL_QUEUE_SPSC mode, at all.
+*	@param	 queue - A pointer to the queue.
+*	@return	 The capacity of the queue, which is a power of two.
+*/
+size_t ll_queue_capacity (const struct ll_queue *queue);
+
+/**
+*	@brief	 ll_queue_append_list() shall enqueue the items of the list pointed 
+*			 to by head, from the head to the tail. The list is left unchanged.
+*	@param	 queue - A pointer to the queue.
+*	@param	 head - A double pointer to the head of the list. Allows *head to be 
+*					NULL, in which case no operation is performed.
+*	@return	 Upon successful return, ll_queue_append_list() returns true. 
+*			 Otherwise it returns false to indicate an allocation failure, or in 
+*			 LL_QUEUE_SPSC mode, that the queue is full. The items enqueued 
+*			 before the failure remain in the queue.
+*/
+bool ll_queue_append_list (struct ll_queue *queue, struct ll_node *const *head);
+
+/**
+*	@brief	 ll_queue_to_list() shall dequeue all the items of the queue into a
+*			 new list, the front of the queue becoming the head of the list. 
+*			 Popping the list with ll_pop_node() thus yields the same order as
+*			 the queue would have. In LL_QUEUE_SPSC mode, only the consumer 
+*			 thread may call it.
+*	@param	 queue - A pointer to the queue.
+*	@param	 head - A double pointer to store the head of the new list in. 
+*					*head is set to NULL if the queue was empty.
+*	@return	 Upon successful return, ll_queue_to_list() returns true. Otherwise 
+*			 it returns false to indicate an allocation failure, in which case
+*			 the queue is left unchanged.
+*/
+bool ll_queue_to_list (struct ll_queue *queue, struct ll_node **head);
+
+#endif
@@ -0,0 +1,233 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdalign.h>
+#include <threads.h>
+#include <assert.h>
+
+#include "sharded.h"
+#include "internal.h"
+
+/*
+ * Shards are padded out to a cache line of their own, so that threads pushing 
+ * to neighbouring shards do not invalidate each other's lines.
+ */
+struct shard {
+    alignas (CACHE_LINE) mtx_t lock;
+    struct ll_node *head;
+    /* 
+     * Items are pushed at the head, so the first node ever pushed stays at the
+     * tail until the shard is drained. Remembering it makes draining O(1).
+     */
+    struct ll_node *tail;
+    intmax_t size;
+};
+
+struct ll_sharded {
+    const struct ll_allocator *allocator;
+    struct shard *shards;
+    size_t mask;
+    enum ll_shard_policy policy;
+    /* 
+     * The allocator does not guarantee cache line alignment, so the shards 
+     * are carved out of a larger block. This is the block to free.
+     */
+    void *block;
+    size_t block_size;
+};
+
+static struct shard *shard_for (struct ll_sharded *list, intmax_t data)
+{
+    if (list->policy == LL_SHARD_BY_HASH) {
+        return &list->shards[ll_hash (data) & list->mask];
+    }
+    return &list->shards[ll_thread_slot () & list->mask];
+}
+
+struct ll_sharded *ll_sharded_create (size_t shards, enum ll_shard_policy policy)
+{
+    if (ISZERO (shards) || shards > SIZE_MAX / 2 / sizeof (struct shard)) {
+        return 0;
+    }
+
+    size_t count = 1;
+
+    while (count < shards) {
+        count <<= 1;
+    }
+
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+    struct ll_sharded *const list = ll_alloc_bytes (allocator, sizeof *list);
+
+    if (ISZERO (list)) {
+        return 0;
+    }
+    list->allocator = allocator;
+    list->block_size = count * sizeof *list->shards + CACHE_LINE - 1;
+    list->block = ll_alloc_bytes (allocator, list->block_size);
+
+    if (ISZERO (list->block)) {
+        ll_free_bytes (allocator, list, sizeof *list);
+        return 0;
+    }
+
+    uintptr_t const addr = (uintptr_t) list->block;
+
+    list->shards = (struct shard *) ((addr + CACHE_LINE - 1) & ~(uintptr_t) (CACHE_LINE - 1));
+    list->mask = count - 1;
+    list->policy = policy;
+
+    for (size_t i = 0; i < count; i++) {
+        if (mtx_init (&list->shards[i].lock, mtx_plain) != thrd_success) {
+            while (i--) {
+                mtx_destroy (&list->shards[i].lock);
+            }
+            ll_free_bytes (allocator, list->block, list->block_size);
+            ll_free_bytes (allocator, list, sizeof *list);
+            return 0;
+        }
+        list->shards[i].head = 0;
+        list->shards[i].tail = 0;
+        list->shards[i].size = 0;
+    }
+    return list;
+}
+
+void ll_sharded_delete (struct ll_sharded **list)
+{
+    assert (list);
+
+    if (ISZERO (*list)) {
+        return;
+    }
+    const struct ll_allocator *const allocator = (*list)->allocator;
+
+    for (size_t i = 0; i <= (*list)->mask; i++) {
+        struct ll_node *node = (*list)->shards[i].head;
+
+        while (ISNONZERO (node)) {
+            struct ll_node *const next = node->next;
+
+            ll_free_node (allocator, node);
+            node = next;
+        }
+        mtx_destroy (&(*list)->shards[i].lock);
+    }
+    ll_free_bytes (allocator, (*list)->block, (*list)->block_size);
+    ll_free_bytes (allocator, *list, sizeof **list);
+    *list = 0;
+}
+
+bool ll_sharded_push (struct ll_sharded *list, intmax_t data)
+{
+    assert (list);
+
+    /* Allocate outside the lock to keep the critical section minimal. */
+    struct ll_node *const new_node = ll_alloc_node (list->allocator);
+
+    if (ISZERO (new_node)) {
+        return false;
+    }
+    new_node->data = data;
+
+    struct shard *const shard = shard_for (list, data);
+
+    mtx_lock (&shard->lock);
+    new_node->next = shard->head;
+    shard->head = new_node;
+    if (ISZERO (shard->tail)) {
+        shard->tail = new_node;
+    }
+    shard->size++;
+    mtx_unlock (&shard->lock);
+    return true;
+}
+
+static size_t count_shard (struct shard *shard, intmax_t data)
+{
+    mtx_lock (&shard->lock);
+    size_t const count = ISZERO (shard->head) ? 0 : ll_count_occurrence (&shard->head, data);
+    mtx_unlock (&shard->lock);
+    return count;
+}
+
+size_t ll_sharded_count_occurrence (struct ll_sharded *list, intmax_t data)
+{
+    assert (list);
+
+    if (list->policy == LL_SHARD_BY_HASH) {
+        return count_shard (shard_for (list, data), data);
+    }
+
+    size_t count = 0;
+
+    for (size_t i = 0; i <= list->mask; i++) {
+        count += count_shard (&list->shards[i], data);
+    }
+    return count;
+}
+
+static bool shard_contains (struct shard *shard, intmax_t data)
+{
+    mtx_lock (&shard->lock);
+    bool const found = ISNONZERO (shard->head) && ll_is_containing (&shard->head, data);
+    mtx_unlock (&shard->lock);
+    return found;
+}
+
+bool ll_sharded_is_containing (struct ll_sharded *list, intmax_t data)
+{
+    assert (list);
+
+    if (list->policy == LL_SHARD_BY_HASH) {
+        return shard_contains (shard_for (list, data), data);
+    }
+    for (size_t i = 0; i <= list->mask; i++) {
+        if (shard_contains (&list->shards[i], data)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+intmax_t ll_sharded_size (struct ll_sharded *list)
+{
+    assert (list);
+
+    intmax_t size = 0;
+
+    for (size_t i = 0; i <= list->mask; i++) {
+        mtx_lock (&list->shards[i].lock);
+        size += list->shards[i].size;
+        mtx_unlock (&list->shards[i].lock);
+    }
+    return size;
+}
+
+struct ll_node *ll_sharded_drain (struct ll_sharded *list)
+{
+    assert (list);
+
+    struct ll_node *head = 0;
+
+    /* 
+     * Each shard is detached under its lock, then linked in front of what has 
+     * been drained so far. The splice needs no lock, as the nodes are ours now.
+     */
+    for (size_t i = 0; i <= list->mask; i++) {
+        struct shard *const shard = &list->shards[i];
+
+        mtx_lock (&shard->lock);
+        struct ll_node *const first = shard->head;
+        struct ll_node *const last = shard->tail;
+
+        shard->head = shard->tail = 0;
+        shard->size = 0;
+        mtx_unlock (&shard->lock);
+
+        if (ISNONZERO (first)) {
+            last->next = head;
+            head = first;
+        }
+    }
+    return head;
+}
@@ -0,0 +1,101 @@
+#ifndef SHARDED_H
+#define SHARDED_H
+
+/*  A concurrent multiset of intmax_t built from several independently locked
+*   lists, so that producers running on different threads rarely contend. The
+*   order of the items is unspecified; use ll_sharded_drain() to obtain an 
+*   ordinary list once the producers are done.
+*
+*   The list owns the allocator in effect for the thread that created it, and
+*   allocates its nodes through it whichever thread pushes them.
+*/
+
+#include "list.h"
+
+struct ll_sharded;
+
+/**
+*	@brief	 Selects the shard an item is pushed to.
+*	@value	 LL_SHARD_BY_THREAD - Each thread is assigned a shard of its own, 
+*								  round-robin, on its first push. This spreads
+*								  producers best.
+*	@value	 LL_SHARD_BY_HASH - Items are placed by a hash of their value, so 
+*								equal items always share a shard. Queries for a
+*								single value then lock only that shard.
+*/
+enum ll_shard_policy {
+    LL_SHARD_BY_THREAD,
+    LL_SHARD_BY_HASH,
+};
+
+/**
+*	@brief	 ll_sharded_create() shall create an empty sharded list.
+*	@param	 shards - The number of shards. It is rounded up to a power of two.
+*					  A good value is the number of producer threads.
+*	@param	 policy - How items are distributed among the shards.
+*	@return	 Upon successful return, ll_sharded_create() shall return a pointer
+*			 to the new list. Otherwise, it shall return a NULL pointer to 
+*			 indicate failure. A NULL pointer is also returned if shards 
+*			 evaluates to 0.
+*/
+struct ll_sharded *ll_sharded_create (size_t shards, enum ll_shard_policy policy);
+
+/**
+*	@brief	 ll_sharded_delete() shall free the list and all the items in it. 
+*			 Allows *list to be NULL, in which case no operation is performed.
+*	@param	 list - A double pointer to the list. *list is set to NULL.
+*	@return	 This function returns nothing.
+*	@warning No other thread shall be using the list.
+*/
+void ll_sharded_delete (struct ll_sharded **list);
+
+/**
+*	@brief	 ll_sharded_push() shall add a new item to the list. It is safe to 
+*			 call concurrently from any number of threads.
+*	@param	 list - A pointer to the list.
+*	@param	 data - The value of the item to add.
+*	@return	 Upon successful return, ll_sharded_push() returns true. Otherwise it 
+*			 returns false to indicate an allocation failure.
+*/
+bool ll_sharded_push (struct ll_sharded *list, intmax_t data);
+
+/**
+*	@brief	 ll_sharded_count_occurrence() shall count the number of occurrences
+*			 of data across all shards. 
+*	@param	 list - A pointer to the list.
+*	@param	 data - The value to search for.
+*	@return	 The number of occurrences of data. Each shard is counted under its
+*			 own lock, so pushes that run concurrently may or may not be seen.
+*/
+size_t ll_sharded_count_occurrence (struct ll_sharded *list, intmax_t data);
+
+/**
+*	@brief	 ll_sharded_is_containing() shall search all shards for data.
+*	@param	 list - A pointer to the list.
+*	@param	 data - The value to search for.
+*	@return	 ll_sharded_is_containing() returns true if data was found. 
+*			 Otherwise it returns false.
+*/
+bool ll_sharded_is_containing (struct ll_sharded *list, intmax_t data);
+
+/**
+*	@brief	 ll_sharded_size() shall count the number of items across all shards.
+*	@param	 list - A pointer to the list.
+*	@return	 The number of items present. This takes time proportional to the 
+*			 number of shards, not items.
+*/
+intmax_t ll_sharded_size (struct ll_sharded *list);
+
+/**
+*	@brief	 ll_sharded_drain() shall remove all items from the list and return
+*			 them as an ordinary list. The sharded list remains usable, and is 
+*			 empty afterwards.
+*	@param	 list - A pointer to the list.
+*	@return	 A pointer to the head of the drained list, which the caller shall 
+*			 release with ll_delete(), with the allocator the sharded list was
+*			 created with in effect. A NULL pointer is returned if the list 
+*			 was empty. Draining takes time proportional to the number of shards.
+*/
+struct ll_node *ll_sharded_drain (struct ll_sharded *list);
+
+#endif
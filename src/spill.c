@@ -0,0 +1,497 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "spill.h"
+#include "internal.h"
+
+/*
+ * The file is an array of slots of SEGMENT_BYTES bytes each. The list is the 
+ * sequence of segments in the table, each of which names the slot holding it,
+ * and the range [start, start + count) of the slot that is in use. A segment 
+ * created by a push fills its slot from the end downwards, and one created by
+ * an append from the beginning upwards, so that both ends of the list grow 
+ * without moving items. Slots freed by ll_spill_remove_if() are kept on a 
+ * stack and reused before the file is extended.
+ *
+ * Slots are read into and written from frames, a fixed set of buffers managed
+ * as a least recently used cache. A frame is only written back when it is 
+ * evicted; when the list is deleted, it is simply dropped. The table itself 
+ * is kept in memory: it costs three size_t per segment.
+ *
+ * Passes over the list visit the segments in table order, and before each
+ * one, ask the system to start reading the next READAHEAD slots. Their order
+ * in the file need not be sequential, which is why this is done rather than
+ * relying on the read-ahead of the file system.
+ */
+#define SEGMENT_ITEMS LL_SPILL_SEGMENT_ITEMS
+#define SEGMENT_BYTES (SEGMENT_ITEMS * sizeof (intmax_t))
+#define READAHEAD     4
+
+struct segment {
+    size_t slot;
+    size_t start;
+    size_t count;
+};
+
+struct frame {
+    intmax_t *items;
+    size_t slot;
+    uint64_t stamp;
+    bool valid;
+    bool dirty;
+};
+
+struct ll_spill {
+    const struct ll_allocator *allocator;
+    int fd;
+    FILE *tmp;
+    char *path;
+    bool error;
+
+    struct segment *segments;
+    size_t nsegments;
+    size_t segment_cap;
+
+    size_t *free_slots;
+    size_t nfree;
+    size_t free_cap;
+    size_t next_slot;
+
+    struct frame *frames;
+    /* The frames with a buffer, of the frame_cap the array was allocated for. */
+    size_t nframes;
+    size_t frame_cap;
+    uint64_t clock;
+
+    size_t size;
+};
+
+static off_t slot_offset (size_t slot)
+{
+    return (off_t) slot * (off_t) SEGMENT_BYTES;
+}
+
+static void free_frames (struct ll_spill *spill)
+{
+    for (size_t i = 0; i < spill->nframes; i++) {
+        ll_free_bytes (spill->allocator, spill->frames[i].items, SEGMENT_BYTES);
+    }
+    ll_free_bytes (spill->allocator, spill->frames, spill->frame_cap * sizeof *spill->frames);
+}
+
+struct ll_spill *ll_spill_create (const char *path, size_t cache_segments)
+{
+    /* 
+     * The head and the tail segments each need a frame, or alternating pushes
+     * and appends would evict one for the other on every call.
+     */
+    if (cache_segments < 2 || cache_segments > SIZE_MAX / sizeof (struct frame)) {
+        return 0;
+    }
+
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+    struct ll_spill *const spill = ll_alloc_bytes (allocator, sizeof *spill);
+
+    if (ISZERO (spill)) {
+        return 0;
+    }
+    *spill = (struct ll_spill) { .allocator = allocator, .fd = -1 };
+
+    spill->frames = ll_alloc_bytes (allocator, cache_segments * sizeof *spill->frames);
+
+    if (ISZERO (spill->frames)) {
+        goto fail;
+    }
+    spill->frame_cap = cache_segments;
+    for (; spill->nframes < cache_segments; spill->nframes++) {
+        struct frame *const frame = &spill->frames[spill->nframes];
+
+        *frame = (struct frame) { .items = ll_alloc_bytes (spill->allocator, SEGMENT_BYTES) };
+        if (ISZERO (frame->items)) {
+            goto fail;
+        }
+        /* Unused parts of a slot are written back too; keep them defined. */
+        memset (frame->items, 0, SEGMENT_BYTES);
+    }
+
+    if (ISZERO (path)) {
+        spill->tmp = tmpfile ();
+        if (ISZERO (spill->tmp)) {
+            goto fail;
+        }
+        spill->fd = fileno (spill->tmp);
+    } else {
+        size_t const len = strlen (path) + 1;
+
+        spill->path = ll_alloc_bytes (spill->allocator, len);
+        if (ISZERO (spill->path)) {
+            goto fail;
+        }
+        memcpy (spill->path, path, len);
+        spill->fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (spill->fd == -1) {
+            goto fail;
+        }
+    }
+    return spill;
+
+  fail:
+    free_frames (spill);
+    if (ISNONZERO (spill->path)) {
+        ll_free_bytes (spill->allocator, spill->path, strlen (spill->path) + 1);
+    }
+    ll_free_bytes (spill->allocator, spill, sizeof *spill);
+    return 0;
+}
+
+void ll_spill_delete (struct ll_spill **spill)
+{
+    assert (spill);
+
+    struct ll_spill *const s = *spill;
+
+    if (ISZERO (s)) {
+        return;
+    }
+    if (ISNONZERO (s->tmp)) {
+        fclose (s->tmp);
+    } else {
+        close (s->fd);
+        unlink (s->path);
+        ll_free_bytes (s->allocator, s->path, strlen (s->path) + 1);
+    }
+    free_frames (s);
+    ll_free_bytes (s->allocator, s->segments, s->segment_cap * sizeof *s->segments);
+    ll_free_bytes (s->allocator, s->free_slots, s->free_cap * sizeof *s->free_slots);
+    ll_free_bytes (s->allocator, s, sizeof *s);
+    *spill = 0;
+}
+
+bool ll_spill_error (const struct ll_spill *spill)
+{
+    assert (spill);
+    return spill->error;
+}
+
+size_t ll_spill_size (const struct ll_spill *spill)
+{
+    assert (spill);
+    return spill->size;
+}
+
+/* Transfers a whole slot, retrying on interruption and short transfers. */
+static bool transfer_slot (struct ll_spill *spill, struct frame *frame, bool write)
+{
+    unsigned char *buf = (unsigned char *) frame->items;
+    size_t left = SEGMENT_BYTES;
+    off_t offset = slot_offset (frame->slot);
+
+    while (left > 0) {
+        ssize_t const n = write ? pwrite (spill->fd, buf, left, offset)
+                                : pread (spill->fd, buf, left, offset);
+
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            spill->error = true;
+            return false;
+        }
+        buf += n;
+        left -= (size_t) n;
+        offset += n;
+    }
+    return true;
+}
+
+/*
+ * Returns the frame holding slot, evicting the least recently used frame if 
+ * it is not cached. If load is false the slot is new, and there is nothing in 
+ * the file to read. Returns a NULL pointer on I/O failure.
+ */
+static struct frame *get_frame (struct ll_spill *spill, size_t slot, bool load)
+{
+    struct frame *victim = &spill->frames[0];
+
+    for (size_t i = 0; i < spill->nframes; i++) {
+        struct frame *const frame = &spill->frames[i];
+
+        if (frame->valid && frame->slot == slot) {
+            frame->stamp = ++spill->clock;
+            return frame;
+        }
+        if (!frame->valid || (victim->valid && frame->stamp < victim->stamp)) {
+            victim = frame;
+        }
+    }
+    if (victim->valid && victim->dirty && !transfer_slot (spill, victim, true)) {
+        return 0;
+    }
+    victim->valid = false;
+    victim->dirty = false;
+    victim->slot = slot;
+    if (load && !transfer_slot (spill, victim, false)) {
+        return 0;
+    }
+    victim->valid = true;
+    victim->stamp = ++spill->clock;
+    return victim;
+}
+
+/* Drops a cached slot without writing it back, as its contents are dead. */
+static void drop_frame (struct ll_spill *spill, size_t slot)
+{
+    for (size_t i = 0; i < spill->nframes; i++) {
+        if (spill->frames[i].valid && spill->frames[i].slot == slot) {
+            spill->frames[i].valid = false;
+            spill->frames[i].dirty = false;
+        }
+    }
+}
+
+static bool is_cached (const struct ll_spill *spill, size_t slot)
+{
+    for (size_t i = 0; i < spill->nframes; i++) {
+        if (spill->frames[i].valid && spill->frames[i].slot == slot) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* 
+ * Called by passes before they get segment index. The advice is only a hint, 
+ * so its failure is not an error.
+ */
+static void read_ahead (const struct ll_spill *spill, size_t index)
+{
+    for (size_t i = index + 1; i <= index + READAHEAD && i < spill->nsegments; i++) {
+        size_t const slot = spill->segments[i].slot;
+
+        if (!is_cached (spill, slot)) {
+            posix_fadvise (spill->fd, slot_offset (slot), (off_t) SEGMENT_BYTES,
+                           POSIX_FADV_WILLNEED);
+        }
+    }
+}
+
+/* Inserts a new, empty segment at index, backed by a free slot. */
+static struct segment *new_segment (struct ll_spill *spill, size_t index,
+                                    size_t start)
+{
+    void *segments = spill->segments;
+
+    if (!ll_reserve (spill->allocator, &segments, &spill->segment_cap, spill->nsegments,
+                     spill->nsegments + 1, sizeof *spill->segments)) {
+        return 0;
+    }
+    spill->segments = segments;
+    memmove (&spill->segments[index + 1], &spill->segments[index],
+             (spill->nsegments - index) * sizeof *spill->segments);
+    spill->nsegments++;
+
+    struct segment *const segment = &spill->segments[index];
+
+    segment->slot = ISNONZERO (spill->nfree) ? spill->free_slots[--spill->nfree]
+                                             : spill->next_slot++;
+    segment->start = start;
+    segment->count = 0;
+    return segment;
+}
+
+/* Undoes new_segment() when the slot could not be brought into a frame. */
+static void remove_segment (struct ll_spill *spill, size_t index)
+{
+    struct segment const segment = spill->segments[index];
+
+    memmove (&spill->segments[index], &spill->segments[index + 1],
+             (spill->nsegments - index - 1) * sizeof *spill->segments);
+    spill->nsegments--;
+    drop_frame (spill, segment.slot);
+    /* 
+     * If the slot came off the stack, there is room to put it back. Otherwise
+     * it was the last one handed out.
+     */
+    if (spill->nfree < spill->free_cap) {
+        spill->free_slots[spill->nfree++] = segment.slot;
+    } else if (segment.slot == spill->next_slot - 1) {
+        spill->next_slot--;
+    }
+}
+
+bool ll_spill_push (struct ll_spill *spill, intmax_t data)
+{
+    assert (spill);
+
+    bool const fresh = ISZERO (spill->nsegments) || ISZERO (spill->segments[0].start);
+    struct segment *segment = fresh ? new_segment (spill, 0, SEGMENT_ITEMS) 
+                                    : &spill->segments[0];
+
+    if (ISZERO (segment)) {
+        return false;
+    }
+
+    struct frame *const frame = get_frame (spill, segment->slot, !fresh);
+
+    if (ISZERO (frame)) {
+        if (fresh) {
+            remove_segment (spill, 0);
+        }
+        return false;
+    }
+    frame->items[--segment->start] = data;
+    frame->dirty = true;
+    segment->count++;
+    spill->size++;
+    return true;
+}
+
+bool ll_spill_append (struct ll_spill *spill, intmax_t data)
+{
+    assert (spill);
+
+    size_t const last = spill->nsegments - 1;
+    bool const fresh = ISZERO (spill->nsegments)
+                       || spill->segments[last].start + spill->segments[last].count == SEGMENT_ITEMS;
+    struct segment *segment = fresh ? new_segment (spill, spill->nsegments, 0) 
+                                    : &spill->segments[last];
+
+    if (ISZERO (segment)) {
+        return false;
+    }
+
+    struct frame *const frame = get_frame (spill, segment->slot, !fresh);
+
+    if (ISZERO (frame)) {
+        if (fresh) {
+            remove_segment (spill, spill->nsegments - 1);
+        }
+        return false;
+    }
+    frame->items[segment->start + segment->count++] = data;
+    frame->dirty = true;
+    spill->size++;
+    return true;
+}
+
+bool ll_spill_for_each (struct ll_spill *spill,
+                        bool (*visit) (intmax_t data, void *context),
+                        void *context)
+{
+    assert (spill && visit);
+
+    for (size_t i = 0; i < spill->nsegments; i++) {
+        struct segment const *const segment = &spill->segments[i];
+
+        read_ahead (spill, i);
+
+        struct frame *const frame = get_frame (spill, segment->slot, true);
+
+        if (ISZERO (frame)) {
+            return false;
+        }
+        for (size_t j = segment->start; j < segment->start + segment->count; j++) {
+            if (!visit (frame->items[j], context)) {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+struct count_state {
+    intmax_t data;
+    size_t count;
+};
+
+static bool count_visit (intmax_t data, void *context)
+{
+    struct count_state *const state = context;
+
+    state->count += data == state->data;
+    return true;
+}
+
+size_t ll_spill_count_occurrence (struct ll_spill *spill, intmax_t data)
+{
+    struct count_state state = { data, 0 };
+
+    ll_spill_for_each (spill, count_visit, &state);
+    return state.count;
+}
+
+/*
+ * Items are compacted towards the start of their segment's range, so each
+ * segment is read once and, if anything was removed from it, written once. 
+ * Segments are not merged: that would save space, but cost a second write of
+ * the survivors.
+ */
+bool ll_spill_remove_if (struct ll_spill *spill,
+                         bool (*predicate) (intmax_t data))
+{
+    assert (spill && predicate);
+
+    if (ISZERO (spill->nsegments)) {
+        return true;
+    }
+
+    size_t kept = 0;
+    size_t i;
+    bool ok = true;
+
+    for (i = 0; i < spill->nsegments; i++) {
+        struct segment segment = spill->segments[i];
+
+        read_ahead (spill, i);
+
+        struct frame *const frame = get_frame (spill, segment.slot, true);
+
+        if (ISZERO (frame)) {
+            ok = false;
+            break;
+        }
+
+        size_t const end = segment.start + segment.count;
+        size_t out = segment.start;
+
+        for (size_t j = segment.start; j < end; j++) {
+            if (!predicate (frame->items[j])) {
+                frame->items[out++] = frame->items[j];
+            }
+        }
+        spill->size -= end - out;
+        segment.count = out - segment.start;
+
+        if (ISZERO (segment.count)) {
+            void *free_slots = spill->free_slots;
+
+            if (ll_reserve (spill->allocator, &free_slots, &spill->free_cap, spill->nfree,
+                            spill->nfree + 1, sizeof *spill->free_slots)) {
+                spill->free_slots = free_slots;
+                spill->free_slots[spill->nfree++] = segment.slot;
+                drop_frame (spill, segment.slot);
+                continue;
+            }
+            /* Without room to record the free slot, keep the empty segment. */
+        }
+        frame->dirty |= out != end;
+        spill->segments[kept++] = segment;
+    }
+    /* On failure, the segments not yet visited are kept as they are. */
+    if (i < spill->nsegments) {
+        memmove (&spill->segments[kept], &spill->segments[i],
+                 (spill->nsegments - i) * sizeof *spill->segments);
+    }
+    spill->nsegments = kept + spill->nsegments - i;
+    return ok;
+}
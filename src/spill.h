@@ -0,0 +1,124 @@
+#ifndef SPILL_H
+#define SPILL_H
+
+/*  A list of intmax_t that lives in a file rather than in memory, for lists
+*   that outgrow it. The items are kept in fixed-size segments of the file, and
+*   only a bounded number of segments are cached in memory at any time, so the
+*   memory used does not depend on the length of the list.
+*
+*   Items can be added at either end. Everything else is a streaming pass over
+*   the whole list, which reads each segment once, in order, and asks the 
+*   system to read ahead of it.
+*
+*   Operations that fail on I/O set a sticky error flag, as stdio does for a 
+*   FILE. Check it with ll_spill_error() after a series of operations.
+*/
+
+#include "list.h"
+
+struct ll_spill;
+
+/**
+*	@brief	 The number of items in a segment of the file.
+*/
+#define LL_SPILL_SEGMENT_ITEMS 4096
+
+/**
+*	@brief	 ll_spill_create() shall create an empty list backed by a file.
+*	@param	 path - The path of the file to use. It is created if need be, and
+*					truncated. If path is a NULL pointer, an anonymous 
+*					temporary file is used.
+*	@param	 cache_segments - The maximum number of segments to keep in memory.
+*							  Each segment takes LL_SPILL_SEGMENT_ITEMS items. It
+*							  shall be at least 2, so that the head and the tail
+*							  segments can both stay in memory.
+*	@return	 Upon successful return, ll_spill_create() shall return a pointer to
+*			 the new list. Otherwise, it shall return a NULL pointer to indicate
+*			 that cache_segments is below 2, a memory allocation failure, or
+*			 that the file could not be opened.
+*/
+struct ll_spill *ll_spill_create (const char *path, size_t cache_segments);
+
+/**
+*	@brief	 ll_spill_delete() shall free the list and close its file. A file 
+*			 given by path is removed. Allows *spill to be NULL, in which case
+*			 no operation is performed.
+*	@param	 spill - A double pointer to the list. *spill is set to NULL.
+*	@return	 This function returns nothing.
+*/
+void ll_spill_delete (struct ll_spill **spill);
+
+/**
+*	@brief	 ll_spill_error() tests the error flag of the list.
+*	@param	 spill - A pointer to the list.
+*	@return	 ll_spill_error() returns true if an operation on the list has 
+*			 failed on I/O since it was created. Otherwise, it returns false.
+*/
+bool ll_spill_error (const struct ll_spill *spill);
+
+/**
+*	@brief	 ll_spill_push() shall add a new item at the beginning of the list.
+*	@param	 spill - A pointer to the list.
+*	@param	 data - The value of the item to add.
+*	@return	 Upon successful return, ll_spill_push() returns true. Otherwise it
+*			 returns false to indicate a memory allocation or I/O failure.
+*/
+bool ll_spill_push (struct ll_spill *spill, intmax_t data);
+
+/**
+*	@brief	 ll_spill_append() shall add a new item at the end of the list.
+*	@param	 spill - A pointer to the list.
+*	@param	 data - The value of the item to add.
+*	@return	 Upon successful return, ll_spill_append() returns true. Otherwise 
+*			 it returns false to indicate a memory allocation or I/O failure.
+*/
+bool ll_spill_append (struct ll_spill *spill, intmax_t data);
+
+/**
+*	@brief	 ll_spill_size() shall return the number of items in the list.
+*	@param	 spill - A pointer to the list.
+*	@return	 The number of items present. This takes constant time, and no I/O.
+*/
+size_t ll_spill_size (const struct ll_spill *spill);
+
+/**
+*	@brief	 ll_spill_for_each() shall call visit for each item of the list, 
+*			 from the first to the last.
+*	@param	 spill - A pointer to the list.
+*	@param	 visit - A pointer to a function taking an item and context, and 
+*					 returning false to end the scan early.
+*	@param	 context - Passed through unmodified to visit.
+*	@return	 Upon successful return, ll_spill_for_each() returns true, whether 
+*			 or not the scan was ended early. Otherwise it returns false to
+*			 indicate an I/O failure.
+*	@warning visit shall not operate on the list.
+*/
+bool ll_spill_for_each (struct ll_spill *spill,
+                        bool (*visit) (intmax_t data, void *context),
+                        void *context);
+
+/**
+*	@brief	 ll_spill_count_occurrence() shall count the number of occurrences
+*			 of data in the list.
+*	@param	 spill - A pointer to the list.
+*	@param	 data - The value to search for.
+*	@return	 The count of the number of occurrences of data. If an I/O failure
+*			 occurs, the error flag is set, and the count is of the items read
+*			 before it.
+*/
+size_t ll_spill_count_occurrence (struct ll_spill *spill, intmax_t data);
+
+/**
+*	@brief	 ll_spill_remove_if() shall remove all items for which predicate 
+*			 returns true. Segments left empty are released for reuse.
+*	@param	 spill - A pointer to the list.
+*	@param	 predicate - A pointer to a function taking an intmax_t and 
+*						 returning a boolean value.
+*	@return	 Upon successful return, ll_spill_remove_if() returns true. Otherwise
+*			 it returns false to indicate an I/O failure, in which case only
+*			 some of the items may have been removed.
+*/
+bool ll_spill_remove_if (struct ll_spill *spill,
+                         bool (*predicate) (intmax_t data));
+
+#endif
@@ -0,0 +1,293 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "view.h"
+#include "internal.h"
+
+enum stage_kind {
+    STAGE_FILTER,
+    STAGE_MAP,
+    STAGE_TAKE,
+    STAGE_SKIP,
+    STAGE_ZIP,
+};
+
+struct stage {
+    enum stage_kind kind;
+    union {
+        bool (*filter) (intmax_t data, void *context);
+        intmax_t (*map) (intmax_t data, void *context);
+        intmax_t (*zip) (intmax_t data, intmax_t other, void *context);
+    } fn;
+    void *context;
+    size_t count;
+    struct ll_node *const *other;
+    /* 
+     * The state of the current pass, reset at its start: the items a take or 
+     * skip stage has left, and the next node of a zip stage.
+     */
+    size_t remaining;
+    const struct ll_node *cursor;
+};
+
+struct ll_view {
+    const struct ll_allocator *allocator;
+    struct ll_node *const *head;
+    struct stage *stages;
+    size_t nstages;
+    size_t cap;
+};
+
+struct ll_view *ll_view_create (struct ll_node *const *head)
+{
+    assert (head);
+
+    const struct ll_allocator *const allocator = ll_get_allocator ();
+    struct ll_view *const view = ll_alloc_bytes (allocator, sizeof *view);
+
+    if (ISNONZERO (view)) {
+        *view = (struct ll_view) { .allocator = allocator, .head = head };
+    }
+    return view;
+}
+
+void ll_view_delete (struct ll_view **view)
+{
+    assert (view);
+
+    if (ISNONZERO (*view)) {
+        const struct ll_allocator *const allocator = (*view)->allocator;
+
+        ll_free_bytes (allocator, (*view)->stages, (*view)->cap * sizeof *(*view)->stages);
+        ll_free_bytes (allocator, *view, sizeof **view);
+        *view = 0;
+    }
+}
+
+static bool add_stage (struct ll_view *view, struct stage stage)
+{
+    assert (view);
+
+    void *stages = view->stages;
+
+    if (!ll_reserve (view->allocator, &stages, &view->cap, view->nstages,
+                     view->nstages + 1, sizeof *view->stages)) {
+        return false;
+    }
+    view->stages = stages;
+    view->stages[view->nstages++] = stage;
+    return true;
+}
+
+bool ll_view_filter (struct ll_view *view,
+                     bool (*predicate) (intmax_t data, void *context),
+                     void *context)
+{
+    assert (predicate);
+    return add_stage (view, (struct stage) {
+        .kind = STAGE_FILTER, .fn.filter = predicate, .context = context });
+}
+
+bool ll_view_map (struct ll_view *view,
+                  intmax_t (*function) (intmax_t data, void *context),
+                  void *context)
+{
+    assert (function);
+    return add_stage (view, (struct stage) {
+        .kind = STAGE_MAP, .fn.map = function, .context = context });
+}
+
+bool ll_view_take (struct ll_view *view, size_t count)
+{
+    return add_stage (view, (struct stage) { .kind = STAGE_TAKE, .count = count });
+}
+
+bool ll_view_skip (struct ll_view *view, size_t count)
+{
+    return add_stage (view, (struct stage) { .kind = STAGE_SKIP, .count = count });
+}
+
+bool ll_view_zip (struct ll_view *view, struct ll_node *const *other,
+                  intmax_t (*combine) (intmax_t data, intmax_t other,
+                                       void *context),
+                  void *context)
+{
+    assert (other && combine);
+    return add_stage (view, (struct stage) {
+        .kind = STAGE_ZIP, .fn.zip = combine, .context = context, .other = other });
+}
+
+/*
+ * This is the fused traversal all the terminal operations share. Each node of
+ * the list is pushed through the stages in turn, and whatever comes out of the
+ * last one is handed to sink, which returns false to end the pass early.
+ *
+ * A pass also ends as soon as no further item could come out: when a take 
+ * stage has let through its last item, or the list of a zip stage runs out. 
+ * The rest of the list is then never read, and upstream callbacks are not
+ * invoked for it.
+ */
+static void run (struct ll_view *view, bool (*sink) (intmax_t data, void *context),
+                 void *context)
+{
+    assert (view);
+
+    for (size_t i = 0; i < view->nstages; i++) {
+        view->stages[i].remaining = view->stages[i].count;
+        view->stages[i].cursor = ISNONZERO (view->stages[i].other) ? *view->stages[i].other : 0;
+    }
+
+    for (const struct ll_node *node = *view->head; ISNONZERO (node); node = node->next) {
+        intmax_t data = node->data;
+        bool drop = false;
+        bool last = false;
+
+        for (size_t i = 0; i < view->nstages && !drop; i++) {
+            struct stage *const stage = &view->stages[i];
+
+            switch (stage->kind) {
+            case STAGE_FILTER:
+                drop = !stage->fn.filter (data, stage->context);
+                break;
+            case STAGE_MAP:
+                data = stage->fn.map (data, stage->context);
+                break;
+            case STAGE_TAKE:
+                if (ISZERO (stage->remaining)) {
+                    return;
+                }
+                last |= --stage->remaining == 0;
+                break;
+            case STAGE_SKIP:
+                if (ISNONZERO (stage->remaining)) {
+                    stage->remaining--;
+                    drop = true;
+                }
+                break;
+            case STAGE_ZIP:
+                if (ISZERO (stage->cursor)) {
+                    return;
+                }
+                data = stage->fn.zip (data, stage->cursor->data, stage->context);
+                stage->cursor = stage->cursor->next;
+                last |= ISZERO (stage->cursor);
+                break;
+            }
+        }
+        if (!drop && !sink (data, context)) {
+            return;
+        }
+        if (last) {
+            return;
+        }
+    }
+}
+
+struct fold_state {
+    intmax_t acc;
+    intmax_t (*function) (intmax_t acc, intmax_t data, void *context);
+    void *context;
+};
+
+static bool fold_sink (intmax_t data, void *context)
+{
+    struct fold_state *const state = context;
+
+    state->acc = state->function (state->acc, data, state->context);
+    return true;
+}
+
+intmax_t ll_view_fold (struct ll_view *view, intmax_t init,
+                       intmax_t (*function) (intmax_t acc, intmax_t data,
+                                             void *context),
+                       void *context)
+{
+    assert (function);
+
+    struct fold_state state = { init, function, context };
+
+    run (view, fold_sink, &state);
+    return state.acc;
+}
+
+static bool count_sink (intmax_t data, void *context)
+{
+    (void) data;
+    ++*(size_t *) context;
+    return true;
+}
+
+size_t ll_view_count (struct ll_view *view)
+{
+    size_t count = 0;
+
+    run (view, count_sink, &count);
+    return count;
+}
+
+/* The collected list is a plain one, so it comes from the calling thread's allocator. */
+struct collect_state {
+    const struct ll_allocator *allocator;
+    struct ll_node *head;
+    struct ll_node **tail;
+    bool failed;
+};
+
+static bool collect_sink (intmax_t data, void *context)
+{
+    struct collect_state *const state = context;
+    struct ll_node *const new_node = ll_alloc_node (state->allocator);
+
+    if (ISZERO (new_node)) {
+        state->failed = true;
+        return false;
+    }
+    new_node->data = data;
+    new_node->next = 0;
+    *state->tail = new_node;
+    state->tail = &new_node->next;
+    return true;
+}
+
+bool ll_view_collect (struct ll_view *view, struct ll_node **head)
+{
+    assert (head);
+
+    struct collect_state state = { ll_get_allocator (), 0, &state.head, false };
+
+    run (view, collect_sink, &state);
+
+    if (state.failed) {
+        ll_delete (&state.head);
+        return false;
+    }
+    *head = state.head;
+    return true;
+}
+
+struct write_state {
+    intmax_t *data;
+    size_t size;
+    size_t count;
+};
+
+static bool write_sink (intmax_t data, void *context)
+{
+    struct write_state *const state = context;
+
+    state->data[state->count++] = data;
+    return state->count < state->size;
+}
+
+size_t ll_view_write (struct ll_view *view, size_t size, intmax_t data[size])
+{
+    assert (data || ISZERO (size));
+
+    struct write_state state = { data, size, 0 };
+
+    if (ISNONZERO (size)) {
+        run (view, write_sink, &state);
+    }
+    return state.count;
+}
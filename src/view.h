@@ -0,0 +1,145 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+/*  A view describes a pipeline of stages - filter, map, take, skip and zip - 
+*   over a list, without running it. Nothing is read until a terminal operation
+*   (fold, count, collect or write) is applied, which then runs all the stages 
+*   in a single pass over the list, item by item. The list is never modified, 
+*   and no intermediate lists are built.
+*
+*   A view refers to the list through its head pointer, so it sees the list as 
+*   it is when a terminal operation runs, and may be run any number of times.
+*/
+
+#include "list.h"
+
+struct ll_view;
+
+/**
+*	@brief	 ll_view_create() shall create a view over the list pointed to by 
+*			 head, with no stages. It yields the items of the list as they are.
+*	@param	 head - A double pointer to the head of the list. Allows *head to be
+*					NULL. head shall remain valid for as long as the view is run.
+*	@return	 Upon successful return, ll_view_create() shall return a pointer to
+*			 the new view. Otherwise, it shall return a NULL pointer to indicate
+*			 a memory allocation failure.
+*/
+struct ll_view *ll_view_create (struct ll_node *const *head);
+
+/**
+*	@brief	 ll_view_delete() shall free the view. The list is left unchanged.
+*			 Allows *view to be NULL, in which case no operation is performed.
+*	@param	 view - A double pointer to the view. *view is set to NULL.
+*	@return	 This function returns nothing.
+*/
+void ll_view_delete (struct ll_view **view);
+
+/**
+*	@brief	 ll_view_filter() shall add a stage that only lets through the items
+*			 for which predicate returns true.
+*	@param	 view - A pointer to the view.
+*	@param	 predicate - A pointer to a function taking an item and context, and 
+*						 returning a boolean value.
+*	@param	 context - Passed through unmodified to predicate.
+*	@return	 Upon successful return, ll_view_filter() returns true. Otherwise it
+*			 returns false to indicate a memory allocation failure, in which 
+*			 case the view is left unchanged. The same holds for all the 
+*			 functions that add a stage.
+*/
+bool ll_view_filter (struct ll_view *view,
+                     bool (*predicate) (intmax_t data, void *context),
+                     void *context);
+
+/**
+*	@brief	 ll_view_map() shall add a stage that replaces each item with the 
+*			 value function returns for it.
+*	@param	 view - A pointer to the view.
+*	@param	 function - A pointer to a function taking an item and context, and
+*						returning the new item.
+*	@param	 context - Passed through unmodified to function.
+*/
+bool ll_view_map (struct ll_view *view,
+                  intmax_t (*function) (intmax_t data, void *context),
+                  void *context);
+
+/**
+*	@brief	 ll_view_take() shall add a stage that lets through the first count
+*			 items, and then ends the pass. Items beyond those are not read.
+*	@param	 view - A pointer to the view.
+*	@param	 count - The number of items to let through.
+*/
+bool ll_view_take (struct ll_view *view, size_t count);
+
+/**
+*	@brief	 ll_view_skip() shall add a stage that drops the first count items
+*			 and lets through the rest.
+*	@param	 view - A pointer to the view.
+*	@param	 count - The number of items to drop.
+*/
+bool ll_view_skip (struct ll_view *view, size_t count);
+
+/**
+*	@brief	 ll_view_zip() shall add a stage that pairs each item with the next 
+*			 item of another list, and replaces it with the value combine 
+*			 returns for the pair. The pass ends when the other list does.
+*	@param	 view - A pointer to the view.
+*	@param	 other - A double pointer to the head of the other list. Allows 
+*					 *other to be NULL. other shall remain valid for as long as 
+*					 the view is run.
+*	@param	 combine - A pointer to a function taking the item, the item of the
+*					   other list, and context, and returning the new item.
+*	@param	 context - Passed through unmodified to combine.
+*/
+bool ll_view_zip (struct ll_view *view, struct ll_node *const *other,
+                  intmax_t (*combine) (intmax_t data, intmax_t other,
+                                       void *context),
+                  void *context);
+
+/**
+*	@brief	 ll_view_fold() shall run the view, and combine the items it yields
+*			 into a single value.
+*	@param	 view - A pointer to the view.
+*	@param	 init - The initial value of the accumulator.
+*	@param	 function - A pointer to a function taking the accumulator, an item 
+*						and context, and returning the new accumulator.
+*	@param	 context - Passed through unmodified to function.
+*	@return	 The final value of the accumulator, which is init if the view
+*			 yields no items.
+*	@warning A view shall not be run again from within one of its own stages.
+*			 The same holds for all the terminal operations.
+*/
+intmax_t ll_view_fold (struct ll_view *view, intmax_t init,
+                       intmax_t (*function) (intmax_t acc, intmax_t data,
+                                             void *context),
+                       void *context);
+
+/**
+*	@brief	 ll_view_count() shall run the view, and count the items it yields.
+*	@param	 view - A pointer to the view.
+*	@return	 The number of items yielded.
+*/
+size_t ll_view_count (struct ll_view *view);
+
+/**
+*	@brief	 ll_view_collect() shall run the view, and build a new list of the
+*			 items it yields, in the same order.
+*	@param	 view - A pointer to the view.
+*	@param	 head - A double pointer to store the head of the new list in. *head
+*					is set to NULL if the view yields no items.
+*	@return	 Upon successful return, ll_view_collect() returns true. Otherwise, 
+*			 it returns false to indicate a memory allocation failure, in which
+*			 case *head is left untouched.
+*/
+bool ll_view_collect (struct ll_view *view, struct ll_node **head);
+
+/**
+*	@brief	 ll_view_write() shall run the view, and write the items it yields
+*			 to an array. The pass ends when the array is full.
+*	@param	 view - A pointer to the view.
+*	@param	 size - The number of elements of data.
+*	@param	 data[size] - The array to write to.
+*	@return	 The number of items written.
+*/
+size_t ll_view_write (struct ll_view *view, size_t size, intmax_t data[size]);
+
+#endif
@@ -0,0 +1,110 @@
+#include <criterion/criterion.h>
+#include <stdint.h>
+#include "../src/packed.h"
+
+#define SIZE 1000
+
+struct ll_packed *packed = 0;
+
+/* Items 0, 3, 6, ... with every tenth one repeated. */
+void setup (void)
+{
+    packed = ll_packed_create ();
+    cr_assert (packed);
+
+    for (intmax_t i = 0; i < SIZE; i++) {
+        cr_assert (ll_packed_append (packed, i * 3));
+        if (i % 10 == 0) {
+            cr_assert (ll_packed_append (packed, i * 3));
+        }
+    }
+}
+
+void tear_down (void)
+{
+    ll_packed_delete (&packed);
+}
+
+TestSuite (packed_tests, .init = setup, .fini = tear_down);
+
+Test (packed_tests, ll_packed_append)
+{
+    cr_assert (ll_packed_size (packed) == SIZE + SIZE / 10);
+    cr_assert (!ll_packed_append (packed, 0));
+    cr_assert (ll_packed_append (packed, INTMAX_MAX));
+    cr_assert (ll_packed_is_containing (packed, INTMAX_MAX));
+}
+
+Test (packed_tests, ll_packed_is_containing)
+{
+    cr_assert (ll_packed_is_containing (packed, 0));
+    cr_assert (ll_packed_is_containing (packed, 1500));
+    cr_assert (ll_packed_is_containing (packed, (SIZE - 1) * 3));
+    cr_assert (!ll_packed_is_containing (packed, 1501));
+    cr_assert (!ll_packed_is_containing (packed, -1));
+    cr_assert (!ll_packed_is_containing (packed, SIZE * 3));
+}
+
+Test (packed_tests, ll_packed_count_occurrence)
+{
+    cr_assert (ll_packed_count_occurrence (packed, 30) == 2);
+    cr_assert (ll_packed_count_occurrence (packed, 33) == 1);
+    cr_assert (ll_packed_count_occurrence (packed, 34) == 0);
+}
+
+Test (packed_tests, ll_packed_next)
+{
+    struct ll_packed_iter iter;
+    intmax_t prev = -1;
+    intmax_t data;
+    size_t count = 0;
+
+    ll_packed_iter_init (&iter, packed);
+    while (ll_packed_next (&iter, &data)) {
+        cr_assert (data >= prev);
+        prev = data;
+        count++;
+    }
+    cr_assert (count == ll_packed_size (packed));
+    cr_assert (prev == (SIZE - 1) * 3);
+}
+
+Test (packed_tests, ll_packed_decode)
+{
+    intmax_t data[SIZE * 2];
+
+    cr_assert (ll_packed_decode (packed, 3, data) == 3);
+    cr_assert (data[0] == 0 && data[1] == 0 && data[2] == 3);
+    cr_assert (ll_packed_decode (packed, SIZE * 2, data) == ll_packed_size (packed));
+    cr_assert (data[SIZE + SIZE / 10 - 1] == (SIZE - 1) * 3);
+}
+
+Test (packed_tests, ll_packed_memory)
+{
+    double per_item;
+
+    cr_assert (ll_packed_memory (packed, &per_item) > 0);
+    cr_assert (per_item < 4.0);
+}
+
+Test (packed_tests1, ll_packed_from_list)
+{
+    struct ll_node *head = 0;
+
+    for (intmax_t i = 0; i < 300; i++) {
+        cr_assert (ll_push_node (&head, INTMAX_MAX - i * 1000000007));
+    }
+    cr_assert (ll_push_node (&head, INTMAX_MIN));
+
+    struct ll_packed *packed = ll_packed_from_list (&head);
+
+    cr_assert (packed);
+    cr_assert (ll_packed_size (packed) == 301);
+    cr_assert (ll_packed_is_containing (packed, INTMAX_MIN));
+    cr_assert (ll_packed_is_containing (packed, INTMAX_MAX - 150 * INTMAX_C (1000000007)));
+    ll_packed_delete (&packed);
+
+    ll_reverse (&head);
+    cr_assert (!ll_packed_from_list (&head));
+    ll_delete (&head);
+}
@@ -0,0 +1,129 @@
+#include <criterion/criterion.h>
+#include <stdint.h>
+#include <threads.h>
+#include "../src/queue.h"
+
+#define SIZE  10
+#define ITEMS 100000
+
+struct ll_queue *queue = 0;
+
+void setup (void)
+{
+    queue = ll_queue_create (SIZE, LL_QUEUE_GROWABLE);
+    cr_assert (queue);
+
+    for (intmax_t i = 0; i < SIZE; i++) {
+        cr_assert (ll_queue_enqueue (queue, i));
+    }
+}
+
+void tear_down (void)
+{
+    ll_queue_delete (&queue);
+}
+
+TestSuite (queue_tests, .init = setup, .fini = tear_down);
+
+Test (queue_tests, ll_queue_capacity)
+{
+    cr_assert (ll_queue_capacity (queue) == 16);
+    cr_assert (ll_queue_size (queue) == SIZE);
+}
+
+Test (queue_tests, ll_queue_dequeue)
+{
+    intmax_t data;
+
+    for (intmax_t i = 0; i < SIZE; i++) {
+        cr_assert (ll_queue_dequeue (queue, &data) && data == i);
+    }
+    cr_assert (!ll_queue_dequeue (queue, &data));
+}
+
+Test (queue_tests, ll_queue_enqueue)
+{
+    intmax_t data;
+
+    /* Wrap around before growing, so the items have to be unwrapped. */
+    for (intmax_t i = 0; i < 5; i++) {
+        cr_assert (ll_queue_dequeue (queue, &data) && data == i);
+    }
+    for (intmax_t i = SIZE; i < 40; i++) {
+        cr_assert (ll_queue_enqueue (queue, i));
+    }
+    cr_assert (ll_queue_capacity (queue) == 64);
+    for (intmax_t i = 5; i < 40; i++) {
+        cr_assert (ll_queue_dequeue (queue, &data) && data == i);
+    }
+    cr_assert (!ll_queue_size (queue));
+}
+
+Test (queue_tests, ll_queue_to_list)
+{
+    struct ll_node *head = 0;
+
+    cr_assert (ll_queue_to_list (queue, &head));
+    cr_assert (!ll_queue_size (queue));
+    cr_assert (ll_size (&head) == SIZE);
+    cr_assert (ll_pop_node (&head) == 0);
+    cr_assert (ll_pop_end (&head) == SIZE - 1);
+
+    cr_assert (ll_queue_append_list (queue, &head));
+    cr_assert (ll_queue_size (queue) == SIZE - 2);
+
+    intmax_t data;
+
+    cr_assert (ll_queue_dequeue (queue, &data) && data == 1);
+    ll_delete (&head);
+}
+
+Test (queue_tests1, ll_queue_spsc_bounded)
+{
+    struct ll_queue *queue = ll_queue_create (4, LL_QUEUE_SPSC);
+
+    cr_assert (queue);
+    for (intmax_t i = 0; i < 4; i++) {
+        cr_assert (ll_queue_enqueue (queue, i));
+    }
+    cr_assert (!ll_queue_enqueue (queue, 4));
+
+    intmax_t data;
+
+    cr_assert (ll_queue_dequeue (queue, &data) && data == 0);
+    cr_assert (ll_queue_enqueue (queue, 4));
+    ll_queue_delete (&queue);
+    cr_assert (!queue);
+}
+
+static int producer (void *arg)
+{
+    struct ll_queue *const queue = arg;
+
+    for (intmax_t i = 0; i < ITEMS; i++) {
+        while (!ll_queue_enqueue (queue, i)) {
+            thrd_yield ();
+        }
+    }
+    return 0;
+}
+
+Test (queue_tests1, ll_queue_spsc_threads)
+{
+    struct ll_queue *queue = ll_queue_create (64, LL_QUEUE_SPSC);
+    thrd_t thread;
+
+    cr_assert (queue);
+    cr_assert (thrd_create (&thread, producer, queue) == thrd_success);
+
+    for (intmax_t i = 0; i < ITEMS; i++) {
+        intmax_t data;
+
+        while (!ll_queue_dequeue (queue, &data)) {
+            thrd_yield ();
+        }
+        cr_assert (data == i);
+    }
+    cr_assert (thrd_join (thread, 0) == thrd_success);
+    ll_queue_delete (&queue);
+}
@@ -0,0 +1,89 @@
+#include <criterion/criterion.h>
+#include <stdint.h>
+#include <threads.h>
+#include "../src/sharded.h"
+
+#define THREADS 4
+#define ITEMS   1000
+
+static int producer (void *arg)
+{
+    struct ll_sharded *const list = arg;
+
+    for (intmax_t i = 0; i < ITEMS; i++) {
+        if (!ll_sharded_push (list, i % 10)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void run_producers (struct ll_sharded *list)
+{
+    thrd_t threads[THREADS];
+
+    for (size_t i = 0; i < THREADS; i++) {
+        cr_assert (thrd_create (&threads[i], producer, list) == thrd_success);
+    }
+    for (size_t i = 0; i < THREADS; i++) {
+        int res;
+
+        cr_assert (thrd_join (threads[i], &res) == thrd_success && !res);
+    }
+}
+
+Test (sharded_tests, ll_sharded_create)
+{
+    cr_assert (!ll_sharded_create (0, LL_SHARD_BY_THREAD));
+
+    struct ll_sharded *list = ll_sharded_create (3, LL_SHARD_BY_THREAD);
+
+    cr_assert (list);
+    cr_assert (ll_sharded_size (list) == 0);
+    cr_assert (!ll_sharded_is_containing (list, 0));
+    cr_assert (!ll_sharded_drain (list));
+    ll_sharded_delete (&list);
+    cr_assert (!list);
+}
+
+Test (sharded_tests, ll_sharded_by_thread)
+{
+    struct ll_sharded *list = ll_sharded_create (THREADS, LL_SHARD_BY_THREAD);
+
+    cr_assert (list);
+    run_producers (list);
+    cr_assert (ll_sharded_size (list) == THREADS * ITEMS);
+    cr_assert (ll_sharded_count_occurrence (list, 3) == THREADS * ITEMS / 10);
+    cr_assert (ll_sharded_is_containing (list, 9));
+    cr_assert (!ll_sharded_is_containing (list, 10));
+    ll_sharded_delete (&list);
+}
+
+Test (sharded_tests, ll_sharded_by_hash)
+{
+    struct ll_sharded *list = ll_sharded_create (THREADS, LL_SHARD_BY_HASH);
+
+    cr_assert (list);
+    run_producers (list);
+    cr_assert (ll_sharded_count_occurrence (list, 7) == THREADS * ITEMS / 10);
+    cr_assert (!ll_sharded_count_occurrence (list, -7));
+    ll_sharded_delete (&list);
+}
+
+Test (sharded_tests, ll_sharded_drain)
+{
+    struct ll_sharded *list = ll_sharded_create (THREADS, LL_SHARD_BY_HASH);
+
+    cr_assert (list);
+    run_producers (list);
+
+    struct ll_node *head = ll_sharded_drain (list);
+
+    cr_assert (ll_size (&head) == THREADS * ITEMS);
+    cr_assert (ll_count_occurrence (&head, 0) == THREADS * ITEMS / 10);
+    cr_assert (ll_sharded_size (list) == 0);
+    cr_assert (ll_sharded_push (list, 42));
+    cr_assert (ll_sharded_is_containing (list, 42));
+    ll_delete (&head);
+    ll_sharded_delete (&list);
+}
@@ -0,0 +1,176 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "../src/spill.h"
+
+#define APPENDED (LL_SPILL_SEGMENT_ITEMS * 3 + 100)
+#define PUSHED   (LL_SPILL_SEGMENT_ITEMS + 7)
+
+struct ll_spill *spill = 0;
+
+/* The list is -PUSHED, ..., -1, 0, ..., APPENDED - 1, over more segments than are cached. */
+void setup (void)
+{
+    spill = ll_spill_create (0, 2);
+    cr_assert (spill);
+
+    for (intmax_t i = 0; i < APPENDED; i++) {
+        cr_assert (ll_spill_append (spill, i));
+    }
+    for (intmax_t i = 1; i <= PUSHED; i++) {
+        cr_assert (ll_spill_push (spill, -i));
+    }
+}
+
+void tear_down (void)
+{
+    cr_assert (!ll_spill_error (spill));
+    ll_spill_delete (&spill);
+}
+
+TestSuite (spill_tests, .init = setup, .fini = tear_down);
+
+struct order_state {
+    intmax_t next;
+    size_t seen;
+    intmax_t step;
+};
+
+static bool check_order (intmax_t data, void *context)
+{
+    struct order_state *const state = context;
+
+    cr_assert (data == state->next);
+    state->next += state->step;
+    state->seen++;
+    return true;
+}
+
+static bool is_even (intmax_t data)
+{
+    return data % 2 == 0;
+}
+
+static bool stop_early (intmax_t data, void *context)
+{
+    (void) data;
+    return ++*(size_t *) context < 10;
+}
+
+Test (spill_tests, ll_spill_size)
+{
+    cr_assert (ll_spill_size (spill) == APPENDED + PUSHED);
+}
+
+Test (spill_tests, ll_spill_for_each)
+{
+    struct order_state state = { -PUSHED, 0, 1 };
+
+    cr_assert (ll_spill_for_each (spill, check_order, &state));
+    cr_assert (state.seen == APPENDED + PUSHED);
+
+    size_t calls = 0;
+
+    cr_assert (ll_spill_for_each (spill, stop_early, &calls));
+    cr_assert (calls == 10);
+}
+
+Test (spill_tests, ll_spill_count_occurrence)
+{
+    cr_assert (ll_spill_append (spill, 42));
+    cr_assert (ll_spill_push (spill, 42));
+    cr_assert (ll_spill_count_occurrence (spill, 42) == 3);
+    cr_assert (ll_spill_count_occurrence (spill, -1) == 1);
+    cr_assert (ll_spill_count_occurrence (spill, APPENDED) == 0);
+}
+
+Test (spill_tests, ll_spill_remove_if)
+{
+    cr_assert (ll_spill_remove_if (spill, is_even));
+    /* Both ends of the list are odd. */
+    cr_assert (ll_spill_size (spill) == (APPENDED + PUSHED + 1) / 2);
+
+    struct order_state state = { -PUSHED, 0, 2 };
+
+    cr_assert (ll_spill_for_each (spill, check_order, &state));
+    cr_assert (state.seen == ll_spill_size (spill));
+
+    /* Both ends still grow after compaction. */
+    cr_assert (ll_spill_push (spill, -PUSHED - 2));
+    cr_assert (ll_spill_append (spill, APPENDED + 1));
+    state = (struct order_state) { -PUSHED - 2, 0, 2 };
+    cr_assert (ll_spill_for_each (spill, check_order, &state));
+    cr_assert (state.seen == ll_spill_size (spill));
+}
+
+static bool always (intmax_t data)
+{
+    (void) data;
+    return true;
+}
+
+static bool never (intmax_t data, void *context)
+{
+    (void) data;
+    (void) context;
+    cr_assert (false);
+    return true;
+}
+
+Test (spill_tests1, ll_spill_empty)
+{
+    struct ll_spill *spill = ll_spill_create (0, 2);
+
+    cr_assert (spill);
+    cr_assert (ll_spill_remove_if (spill, always));
+    cr_assert (ll_spill_for_each (spill, never, 0));
+    cr_assert (ll_spill_count_occurrence (spill, 0) == 0);
+    cr_assert (ll_spill_size (spill) == 0 && !ll_spill_error (spill));
+    ll_spill_delete (&spill);
+}
+
+/* A directory of its own, so a failed test leaves nothing in the working one. */
+static char dir[] = "/tmp/spill_tests.XXXXXX";
+static char path[sizeof dir + sizeof "/spill"];
+
+void make_dir (void)
+{
+    cr_assert (mkdtemp (dir));
+    snprintf (path, sizeof path, "%s/spill", dir);
+}
+
+void remove_dir (void)
+{
+    remove (path);
+    remove (dir);
+}
+
+TestSuite (spill_tests2, .init = make_dir, .fini = remove_dir);
+
+Test (spill_tests2, ll_spill_create)
+{
+    cr_assert (!ll_spill_create (path, 0) && !ll_spill_create (path, 1));
+
+    struct ll_spill *spill = ll_spill_create (path, 2);
+
+    cr_assert (spill);
+    for (intmax_t i = 0; i < LL_SPILL_SEGMENT_ITEMS * 2; i++) {
+        cr_assert (ll_spill_append (spill, i));
+    }
+    cr_assert (ll_spill_count_occurrence (spill, 5) == 1);
+    cr_assert (ll_spill_remove_if (spill, always));
+    cr_assert (ll_spill_size (spill) == 0);
+    cr_assert (ll_spill_push (spill, 1) && ll_spill_count_occurrence (spill, 1) == 1);
+    cr_assert (!ll_spill_error (spill));
+
+    FILE *file = fopen (path, "rb");
+
+    cr_assert (file);
+    fclose (file);
+    ll_spill_delete (&spill);
+    cr_assert (!spill);
+    cr_assert (!fopen (path, "rb"));
+}
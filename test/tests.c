@@ -1,5 +1,7 @@
 #include <criterion/criterion.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <threads.h>
 #include "../src/list.h"
 
 #define SIZE 10
@@ -180,3 +182,230 @@ Test (list_tests, ll_is_containing)
     cr_assert (!ll_is_containing (&head, 39283108883088311209));
 }
 
+
+/* The context of an arena counts the blocks it has live. */
+static void *arena_alloc (void *context, size_t size)
+{
+    ++*(size_t *) context;
+    return malloc (size);
+}
+
+static void arena_free (void *context, void *ptr, size_t size)
+{
+    (void) size;
+    --*(size_t *) context;
+    free (ptr);
+}
+
+Test (list_tests, ll_memory_usage)
+{
+    cr_assert (ll_memory_usage (0).nodes == SIZE);
+    cr_assert (ll_memory_usage (0).bytes > 0);
+    cr_assert (ll_pop_node (&head) == 9);
+    cr_assert (ll_memory_usage (0).nodes == SIZE - 1);
+}
+
+Test (list_tests1, ll_set_allocator)
+{
+    size_t live = 0;
+    struct ll_allocator arena = { .alloc = arena_alloc, .free = arena_free, .context = &live };
+
+    cr_assert (ll_allocator_init (&arena));
+    cr_assert (!ll_memory_usage (&arena).nodes);
+    ll_set_allocator (&arena);
+
+    struct ll_node *head = ll_build_head (SIZE, 0);
+
+    cr_assert (head && ll_get_allocator () == &arena);
+    cr_assert (live == SIZE);
+    cr_assert (ll_memory_usage (&arena).nodes == SIZE);
+    cr_assert (ll_memory_usage (0).nodes == 0);
+
+    ll_delete (&head);
+    cr_assert (!live);
+    cr_assert (!ll_memory_usage (&arena).nodes && !ll_memory_usage (&arena).bytes);
+    ll_set_allocator (0);
+    cr_assert (ll_get_allocator () != &arena);
+    ll_allocator_destroy (&arena);
+}
+
+Test (list_tests1, ll_allocator_init)
+{
+    size_t live = 0;
+    struct ll_allocator arena = { .alloc = arena_alloc, .free = arena_free, .context = &live };
+    struct ll_node *head = 0;
+
+    /* A new allocator at the address of a destroyed one starts from 0. */
+    cr_assert (ll_allocator_init (&arena));
+    ll_set_allocator (&arena);
+    cr_assert (ll_push_node (&head, 1) && ll_push_node (&head, 2));
+    cr_assert (ll_memory_usage (&arena).nodes == 2);
+    ll_set_allocator (0);
+    ll_allocator_destroy (&arena);
+    cr_assert (!arena.stats);
+
+    cr_assert (ll_allocator_init (&arena));
+    cr_assert (!ll_memory_usage (&arena).nodes && !ll_memory_usage (&arena).bytes);
+    ll_set_allocator (&arena);
+    ll_delete (&head);
+    ll_set_allocator (0);
+    cr_assert (!live);
+    ll_allocator_destroy (&arena);
+}
+
+Test (list_tests1, ll_set_allocator_per_list)
+{
+    size_t live_a = 0;
+    size_t live_b = 0;
+    struct ll_allocator arena_a = { .alloc = arena_alloc, .free = arena_free, .context = &live_a };
+    struct ll_allocator arena_b = { .alloc = arena_alloc, .free = arena_free, .context = &live_b };
+    struct ll_node *list_a = 0;
+    struct ll_node *list_b = 0;
+
+    cr_assert (ll_allocator_init (&arena_a) && ll_allocator_init (&arena_b));
+    for (intmax_t i = 0; i < SIZE; i++) {
+        ll_set_allocator (&arena_a);
+        cr_assert (ll_push_node (&list_a, i));
+        ll_set_allocator (&arena_b);
+        cr_assert (ll_push_node (&list_b, i));
+        cr_assert (ll_push_node (&list_b, -i));
+    }
+    cr_assert (ll_memory_usage (&arena_a).nodes == SIZE && live_a == SIZE);
+    cr_assert (ll_memory_usage (&arena_b).nodes == 2 * SIZE && live_b == 2 * SIZE);
+
+    ll_set_allocator (&arena_a);
+    ll_delete (&list_a);
+    ll_set_allocator (&arena_b);
+    ll_delete (&list_b);
+    ll_set_allocator (0);
+
+    cr_assert (!live_a && !live_b);
+    cr_assert (!ll_memory_usage (&arena_a).nodes && !ll_memory_usage (&arena_a).bytes);
+    cr_assert (!ll_memory_usage (&arena_b).nodes && !ll_memory_usage (&arena_b).bytes);
+    ll_allocator_destroy (&arena_a);
+    ll_allocator_destroy (&arena_b);
+}
+
+/* Builds and deletes a list, failing unless arg is the allocator in effect. */
+static int build_with (void *arg)
+{
+    struct ll_node *head = 0;
+
+    if (ll_get_allocator () != arg) {
+        return 1;
+    }
+    for (intmax_t i = 0; i < 1000; i++) {
+        if (!ll_push_node (&head, i)) {
+            return 1;
+        }
+    }
+    ll_delete (&head);
+    return 0;
+}
+
+static int build_under (void *arg)
+{
+    ll_set_allocator (arg);
+    return build_with (arg);
+}
+
+Test (list_tests1, ll_set_allocator_per_thread)
+{
+    size_t live_a = 0;
+    size_t live_b = 0;
+    struct ll_allocator arena_a = { .alloc = arena_alloc, .free = arena_free, .context = &live_a };
+    struct ll_allocator arena_b = { .alloc = arena_alloc, .free = arena_free, .context = &live_b };
+    struct ll_node *head = 0;
+    thrd_t thread;
+    int res;
+
+    cr_assert (ll_allocator_init (&arena_a) && ll_allocator_init (&arena_b));
+    ll_set_allocator (&arena_a);
+    cr_assert (thrd_create (&thread, build_under, &arena_b) == thrd_success);
+    for (intmax_t i = 0; i < 1000; i++) {
+        cr_assert (ll_push_node (&head, i));
+    }
+    cr_assert (thrd_join (thread, &res) == thrd_success && !res);
+
+    cr_assert (ll_get_allocator () == &arena_a);
+    cr_assert (ll_memory_usage (&arena_a).nodes == 1000 && live_a == 1000);
+    cr_assert (!ll_memory_usage (&arena_b).nodes && !live_b);
+
+    ll_delete (&head);
+    cr_assert (!ll_memory_usage (&arena_a).nodes && !live_a);
+    ll_set_allocator (0);
+    ll_allocator_destroy (&arena_a);
+    ll_allocator_destroy (&arena_b);
+}
+
+Test (list_tests1, ll_set_default_allocator)
+{
+    size_t live = 0;
+    size_t other_live = 0;
+    struct ll_allocator arena = { .alloc = arena_alloc, .free = arena_free, .context = &live };
+    struct ll_allocator other = { .alloc = arena_alloc, .free = arena_free, .context = &other_live };
+    thrd_t thread;
+    int res;
+
+    cr_assert (ll_allocator_init (&arena) && ll_allocator_init (&other));
+    ll_set_default_allocator (&arena);
+    cr_assert (ll_get_allocator () == &arena);
+
+    /* A thread without an override picks up the process-wide allocator. */
+    cr_assert (thrd_create (&thread, build_with, &arena) == thrd_success);
+    cr_assert (thrd_join (thread, &res) == thrd_success && !res);
+    cr_assert (!live && !ll_memory_usage (&arena).nodes);
+
+    /* An override wins over it, and removing the override restores it. */
+    ll_set_allocator (&other);
+    cr_assert (ll_get_allocator () == &other);
+    ll_set_allocator (0);
+    cr_assert (ll_get_allocator () == &arena);
+
+    struct ll_node *head = ll_build_head (SIZE, 0);
+
+    cr_assert (head && live == SIZE && ll_memory_usage (&arena).nodes == SIZE);
+    cr_assert (!ll_memory_usage (0).nodes && !other_live);
+    ll_delete (&head);
+    cr_assert (!live && !ll_memory_usage (&arena).bytes);
+
+    ll_set_default_allocator (0);
+    cr_assert (ll_get_allocator () != &arena);
+    ll_allocator_destroy (&arena);
+    ll_allocator_destroy (&other);
+}
+
+Test (list_tests, ll_count_many)
+{
+    intmax_t const keys[] = { 2, 42, 5, 2 };
+    size_t counts[4];
+
+    cr_assert (ll_push_node (&head, 5));
+    cr_assert (ll_count_many (&head, 4, keys, counts));
+    cr_assert (counts[0] == 1 && counts[1] == 0 && counts[2] == 2 && counts[3] == 1);
+}
+
+Test (list_tests, ll_remove_set)
+{
+    intmax_t const keys[] = { 0, 9, 4, 4, 100 };
+
+    cr_assert (ll_remove_set (&head, 5, keys));
+    cr_assert (ll_size (&head) == SIZE - 3);
+    cr_assert (!ll_is_containing (&head, 0) && !ll_is_containing (&head, 9)
+               && !ll_is_containing (&head, 4));
+    cr_assert (ll_is_containing (&head, 5));
+}
+
+Test (list_tests, ll_replace_map)
+{
+    intmax_t const old_data[] = { 9, 8, 1, 9 };
+    intmax_t const new_data[] = { 8, 7, 100, 200 };
+
+    cr_assert (ll_push_node (&head, 1));
+    cr_assert (ll_replace_map (&head, 4, old_data, new_data));
+    cr_assert (ll_pop_node (&head) == 100);
+    cr_assert (ll_pop_node (&head) == 8);
+    cr_assert (ll_pop_node (&head) == 7);
+    cr_assert (ll_pop_node (&head) == 7);
+    cr_assert (ll_count_occurrence (&head, 1) == 1);
+}
@@ -0,0 +1,134 @@
+#include <criterion/criterion.h>
+#include <stdint.h>
+#include "../src/view.h"
+
+#define SIZE 10
+
+struct ll_node *head = 0;
+struct ll_view *view = 0;
+
+/* The list is 9, 8, ..., 0. */
+void setup (void)
+{
+    intmax_t limits[SIZE];
+
+    for (intmax_t i = 0; i < SIZE; i++) {
+        limits[i] = i;
+    }
+
+    head = ll_build_head (SIZE, limits);
+    cr_assert (head);
+    view = ll_view_create (&head);
+    cr_assert (view);
+}
+
+void tear_down (void)
+{
+    ll_view_delete (&view);
+    ll_delete (&head);
+}
+
+TestSuite (view_tests, .init = setup, .fini = tear_down);
+
+static bool is_even (intmax_t data, void *context)
+{
+    (void) context;
+    return data % 2 == 0;
+}
+
+static intmax_t scale (intmax_t data, void *context)
+{
+    return data * *(intmax_t *) context;
+}
+
+static intmax_t sum (intmax_t acc, intmax_t data, void *context)
+{
+    (void) context;
+    return acc + data;
+}
+
+static intmax_t subtract (intmax_t data, intmax_t other, void *context)
+{
+    ++*(size_t *) context;
+    return data - other;
+}
+
+static size_t calls = 0;
+
+static bool counting (intmax_t data, void *context)
+{
+    (void) data;
+    (void) context;
+    calls++;
+    return true;
+}
+
+Test (view_tests, ll_view_count)
+{
+    cr_assert (ll_view_count (view) == SIZE);
+    cr_assert (ll_view_filter (view, is_even, 0));
+    cr_assert (ll_view_count (view) == SIZE / 2);
+    cr_assert (ll_size (&head) == SIZE);
+}
+
+Test (view_tests, ll_view_fold)
+{
+    intmax_t factor = 10;
+
+    cr_assert (ll_view_filter (view, is_even, 0));
+    cr_assert (ll_view_map (view, scale, &factor));
+    cr_assert (ll_view_fold (view, 0, sum, 0) == (8 + 6 + 4 + 2) * 10);
+
+    /* Views are lazy, and see the list as it is when they run. */
+    cr_assert (ll_push_node (&head, 100));
+    cr_assert (ll_view_fold (view, 1, sum, 0) == 1 + (100 + 8 + 6 + 4 + 2) * 10);
+}
+
+Test (view_tests, ll_view_take)
+{
+    intmax_t data[SIZE];
+
+    cr_assert (ll_view_filter (view, counting, 0));
+    cr_assert (ll_view_skip (view, 2));
+    cr_assert (ll_view_take (view, 3));
+    cr_assert (ll_view_write (view, SIZE, data) == 3);
+    cr_assert (data[0] == 7 && data[1] == 6 && data[2] == 5);
+    cr_assert (calls == 5);
+}
+
+Test (view_tests, ll_view_zip)
+{
+    struct ll_node *other = ll_build_head (3, (intmax_t[]) { 1, 2, 3 });
+    size_t pairs = 0;
+
+    cr_assert (other);
+    cr_assert (ll_view_zip (view, &other, subtract, &pairs));
+    cr_assert (ll_view_fold (view, 0, sum, 0) == (9 - 3) + (8 - 2) + (7 - 1));
+    cr_assert (pairs == 3);
+    ll_delete (&other);
+}
+
+Test (view_tests, ll_view_collect)
+{
+    struct ll_node *evens = 0;
+
+    cr_assert (ll_view_filter (view, is_even, 0));
+    cr_assert (ll_view_collect (view, &evens));
+    cr_assert (ll_size (&evens) == SIZE / 2);
+    cr_assert (ll_pop_node (&evens) == 8);
+    cr_assert (ll_pop_end (&evens) == 0);
+    ll_delete (&evens);
+
+    cr_assert (ll_view_take (view, 0));
+    cr_assert (ll_view_collect (view, &evens));
+    cr_assert (ll_is_empty (&evens));
+}
+
+Test (view_tests, ll_view_write)
+{
+    intmax_t data[4];
+
+    cr_assert (ll_view_write (view, 4, data) == 4);
+    cr_assert (data[0] == 9 && data[3] == 6);
+    cr_assert (ll_view_write (view, 0, 0) == 0);
+}